@@ -55,6 +55,8 @@
 #endif
 #endif
 
+/* option: NMS_SIZE64, 64-bit size/stride for View, List and Array (see nms::usize) */
+
 /* define: NMS_ABI */
 #ifndef NMS_ABI
 #   define NMS_ABI extern "C" NMS_API
@@ -13,6 +13,8 @@
 #include <nms/core/delegate.h>
 #include <nms/core/string.h>
 #include <nms/core/format.h>
+#include <nms/core/symbol.h>
+#include <nms/core/hashmap.h>
 #include <nms/core/parse.h>
 
 #include <nms/core/time.h>
@@ -24,6 +24,13 @@ using   llong       = long long;
 using   ullong      = unsigned long long;
 using   nullptr_t   = decltype(nullptr);
 
+/* size/stride of View, List, Array: u32 by default, u64 with NMS_SIZE64 (more than 4G elements) */
+#ifdef NMS_SIZE64
+using   usize       = u64;
+#else
+using   usize       = u32;
+#endif
+
 template<class T>
 constexpr T* declptr() {
     return static_cast<T*>(nullptr);
@@ -221,7 +228,7 @@ struct Vec<T, N>
     template<class I> __forceinline const T& operator[] (I idx) const noexcept { return data_[idx]; }
 
     bool operator==(const Vec& v) const {
-        for (u32 i = 0; i < $rank; ++i) {
+        for (u32 i = 0; i < $count; ++i) {
             if (data_[i] != v.data_[i]) {
                 return false;
             }
@@ -0,0 +1,137 @@
+#include <nms/test.h>
+#include <nms/core/delegate.h>
+#include <nms/core/string.h>
+#include <nms/core/time.h>
+#include <nms/io/log.h>
+
+namespace nms
+{
+
+#pragma region unittest
+
+namespace
+{
+/* move only callable */
+struct MoveOnly
+{
+    u32* cnt;
+
+    explicit MoveOnly(u32* c)
+        : cnt(c)
+    {}
+
+    MoveOnly(MoveOnly&& rhs) noexcept
+        : cnt(rhs.cnt) {
+        rhs.cnt = nullptr;
+    }
+
+    MoveOnly(const MoveOnly&) = delete;
+
+    ~MoveOnly() {
+        if (cnt != nullptr) {
+            ++*cnt;
+        }
+    }
+
+    u32 operator()(u32 x) {
+        return x + 1;
+    }
+};
+
+u32 addOne(u32 x) {
+    return x + 1;
+}
+}
+
+nms_test(delegate) {
+    // empty
+    delegate<u32(u32)> empty;
+    test::assert_eq(bool(empty), false);
+
+    auto thrown = false;
+    try {
+        empty(0);
+    }
+    catch (const delegate<u32(u32)>::EInvalid&) {
+        thrown = true;
+    }
+    test::assert_eq(thrown, true);
+
+    // trivially copyable, inline
+    const u32 base = 10;
+    delegate<u32(u32)> add([=](u32 x) { return x + base; });
+    test::assert_eq(add(1), 11u);
+
+    delegate<u32(u32)> moved(static_cast<delegate<u32(u32)>&&>(add));
+    test::assert_eq(bool(add), false);
+    test::assert_eq(moved(2), 12u);
+
+    // non-trivial capture
+    const String str = "abc";
+    delegate<u32()> len([=] { return str.count(); });
+    test::assert_eq(len(), 3u);
+
+    // move only, destroyed once
+    auto dtors = 0u;
+    {
+        delegate<u32(u32)> f(MoveOnly{ &dtors });
+        delegate<u32(u32)> g;
+        g = static_cast<delegate<u32(u32)>&&>(f);
+        test::assert_eq(g(1), 2u);
+    }
+    test::assert_eq(dtors, 1u);
+
+    // larger inline capacity
+    u64 data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    auto sum = [=] { u64 s = 0; for (auto v : data) s += v; return s; };
+    test::assert_eq(delegate<u64()>::isInline<decltype(sum)>(), false);
+    test::assert_eq((delegate<u64(), 64>::isInline<decltype(sum)>()), true);
+
+    delegate<u64()>     heap(sum);
+    delegate<u64(), 64> inln(sum);
+    test::assert_eq(heap(), 36ull);
+    test::assert_eq(inln(), 36ull);
+
+    // reference
+    auto calls = 0u;
+    auto count = [&](u32 x) { calls += x; };
+    delegate_ref<void(u32)> ref(count);
+    ref(1);
+    ref(2);
+    test::assert_eq(calls, 3u);
+
+    // reference to a function, and to a function pointer
+    delegate_ref<u32(u32)> fref(addOne);
+    test::assert_eq(fref(1), 2u);
+
+    u32(*pfunc)(u32) = addOne;
+    delegate_ref<u32(u32)> pref(pfunc);
+    test::assert_eq(pref(2), 3u);
+}
+
+nms_test(delegate_bench) {
+    static const u32 $count = 10000000;
+
+    auto val = 0u;
+    delegate<void(u32)>     func([&val](u32 x) { val += x; });
+    auto lambda = [&val](u32 x) { val += x; };
+    delegate_ref<void(u32)> ref(lambda);
+
+    const auto t0 = clock();
+    for (u32 i = 0; i < $count; ++i) {
+        func(1);
+    }
+    const auto t1 = clock();
+    for (u32 i = 0; i < $count; ++i) {
+        ref(1);
+    }
+    const auto t2 = clock();
+
+    test::assert_eq(val, $count * 2);
+    io::log::info("nms.delegate: {} calls, delegate {:.2f} ns, delegate_ref {:.2f} ns",
+        $count, (t1 - t0) * 1e9 / $count, (t2 - t1) * 1e9 / $count);
+}
+
+#pragma endregion
+
+}
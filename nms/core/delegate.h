@@ -6,142 +6,202 @@
 namespace nms
 {
 
-template<class F>
+/* default inline capacity of delegate: with the 2 function pointers, a delegate fills a cache line */
+constexpr static const u32 $delegate_size = 48;
+
+template<class F, u32 N = $delegate_size>
 class delegate;
 
+template<class F>
+class delegate_ref;
+
 namespace ns_delegate
 {
 
-template<class T>
-class ILambda;
-
-template<class T, class F>
-class TLambda;
+class EInvalid: public IException
+{};
 
 template<class R, class ...T>
-class ILambda<R(T...)>
-{
-public:
-    virtual ~ILambda()
-    {}
+R invokeEmpty(void*, T...) {
+    NMS_THROW(EInvalid{});
+}
 
-    virtual R operator()(T ...) = 0;
-};
+/* callable stored in the buffer */
+template<class F, class R, class ...T>
+R invokeInline(void* obj, T ...t) {
+    return (*static_cast<F*>(obj))(static_cast<T&&>(t)...);
+}
 
-template<class R, class ...T, class F>
-class TLambda<R(T...), F>
-    : public F
-    , public ILambda<R(T...)>
-{
-public:
-    TLambda(F&& f)
-        : F(static_cast<F&&>(f))
-    {}
+/* callable allocated, the buffer stores the pointer */
+template<class F, class R, class ...T>
+R invokeHeap(void* obj, T ...t) {
+    return (**static_cast<F**>(obj))(static_cast<T&&>(t)...);
+}
+
+/* plain function, `obj` is the function pointer */
+template<class F, class R, class ...T>
+R invokeFunc(void* obj, T ...t) {
+    return reinterpret_cast<F>(obj)(static_cast<T&&>(t)...);
+}
+
+/* the function pointer type of a function or function pointer, void for others */
+template<class F>               struct _Tfunc                       { using U = void;         };
+template<class Rf, class ...Tf> struct _Tfunc<Rf(Tf...)>            { using U = Rf(*)(Tf...); };
+template<class Rf, class ...Tf> struct _Tfunc<Rf(*)(Tf...)>         { using U = Rf(*)(Tf...); };
+template<class Rf, class ...Tf> struct _Tfunc<Rf(* const)(Tf...)>   { using U = Rf(*)(Tf...); };
 
-    R operator()(T ...t) override {
-        return F::operator()(t...);
+/* move `src` to `dst` and destroy `src`, or only destroy `src` if `dst` is nullptr */
+template<class F>
+void manageInline(void* dst, void* src) {
+    const auto f = static_cast<F*>(src);
+    if (dst != nullptr) {
+        new(dst)F(static_cast<F&&>(*f));
     }
-};
+    f->~F();
+}
 
+template<class F>
+void manageHeap(void* dst, void* src) {
+    const auto pf = static_cast<F**>(src);
+    if (dst != nullptr) {
+        *static_cast<F**>(dst) = *pf;
+        return;
+    }
+    (*pf)->~F();
+    mdel(*pf);
 }
 
-template<class R, class ...T>
-class delegate<R(T...)> final
+}
+
+/*!
+ * owning callable wrapper, move only.
+ * a callable which fits `N` bytes is stored inline, a larger one is allocated.
+ * call: one indirect call, no vtable.
+ * trivially copyable callables (e.g. lambdas capturing PODs) are moved by memcpy, and need no destructor.
+ */
+template<class R, class ...T, u32 N>
+class delegate<R(T...), N> final
     : public INocopyable
 {
 public:
-    class EInvalid: public IException
-    {};
+    using EInvalid = ns_delegate::EInvalid;
+
+    constexpr static const u32 $capacity = N;
+
+    static_assert(N >= sizeof(void*), "nms.delegate: N should be able to store a pointer");
 
     constexpr delegate() noexcept
-        : data_(nullptr)
-    {
-        buff_[sizeof(buff_) - 1] = 0;
-    }
+        : invoke_(&ns_delegate::invokeEmpty<R, T...>), manage_(nullptr), buff_{}
+    {}
 
-    template<class F>
-    explicit delegate(F&& f) {
-        using TLambda = ns_delegate::TLambda<R(T...), F>;
-        buff_[sizeof(buff_) - 1] = sizeof(TLambda) < u8(0xFF) ? sizeof(TLambda) : u8(0xFF);
+    template<class F, class = $when<!$is<delegate, Tmutable<Tvalue<F>>>>>
+    explicit delegate(F&& f)
+        : delegate{} {
+        using Tfunc = Tmutable<Tvalue<F>>;
 
-        if (sizeof(TLambda) < sizeof(buff_)) {
-            new(buff_)TLambda(static_cast<F&&>(f));
+        if constexpr (isInline<Tfunc>()) {
+            new(buff_)Tfunc(fwd<F>(f));
+            invoke_ = &ns_delegate::invokeInline<Tfunc, R, T...>;
+            manage_ = $is_trivially_copyable<Tfunc> ? nullptr : &ns_delegate::manageInline<Tfunc>;
         }
         else {
-            data_ = mnew<TLambda>(1);
-            new(data_)TLambda(static_cast<F&&>(f));
+            const auto ptr = mnew<Tfunc>(1);
+            new(ptr)Tfunc(fwd<F>(f));
+            *reinterpret_cast<Tfunc**>(buff_) = ptr;
+            invoke_ = &ns_delegate::invokeHeap<Tfunc, R, T...>;
+            manage_ = &ns_delegate::manageHeap<Tfunc>;
         }
     }
 
     ~delegate() {
-        // empty
-        if (buff_[sizeof(buff_) - 1] == 0) {
-        }
-        // buff
-        else if (buff_[sizeof(buff_) - 1] < sizeof(buff_) ) {
-            reinterpret_cast<ILambda*>(buff_)->~ILambda();
-        }
-        // data
-        else {
-            data_->~ILambda();
-            mdel(data_);
+        if (manage_ != nullptr) {
+            manage_(nullptr, buff_);
         }
     }
 
-    delegate(delegate&& rhs) noexcept {
-        for (u32 i = 0; i < sizeof(buff_); ++i) {
-            buff_[i]     = rhs.buff_[i];
-            rhs.buff_[i] = 0;
+    delegate(delegate&& rhs) noexcept
+        : invoke_(rhs.invoke_), manage_(rhs.manage_) {
+        if (manage_ != nullptr) {
+            manage_(buff_, rhs.buff_);
+        }
+        else {
+            mcpy(buff_, rhs.buff_, N);
         }
+        rhs.invoke_ = &ns_delegate::invokeEmpty<R, T...>;
+        rhs.manage_ = nullptr;
     }
 
-    /* copy construct */
     delegate& operator=(delegate&& rhs) noexcept {
-        swap(buff_, rhs.buff_);
+        if (this != &rhs) {
+            this->~delegate();
+            new(this)delegate(static_cast<delegate&&>(rhs));
+        }
         return *this;
     }
 
     /* reset */
-    template<class U>
-    delegate& operator=(U&& u) noexcept {
+    template<class U, class = $when<!$is<delegate, Tmutable<Tvalue<U>>>>>
+    delegate& operator=(U&& u) {
         delegate tmp(fwd<U>(u));
-        nms::swap(*this, tmp);
+        *this = static_cast<delegate&&>(tmp);
         return *this;
     }
 
-    template<class ...U>
-    R operator()(U&& ...u) {
-        return (*lambda())(fwd<U>(u)...);
+    /* test if callable `F` is stored inline */
+    template<class F>
+    constexpr static bool isInline() {
+        return sizeof(F) <= N && alignof(F) <= 16;
+    }
+
+    R operator()(T ...t) {
+        return invoke_(buff_, static_cast<T&&>(t)...);
     }
 
     __forceinline operator bool()  const noexcept {
-        return buff_[sizeof(buff_) - 1] != 0;
+        return invoke_ != &ns_delegate::invokeEmpty<R, T...>;
     }
 
     __forceinline bool operator!() const noexcept {
-        return buff_[sizeof(buff_) - 1] == 0; 
+        return invoke_ == &ns_delegate::invokeEmpty<R, T...>;
     }
 
 private:
-    using ILambda = ns_delegate::ILambda<R(T...)>;
+    R   (*invoke_)(void*, T...);
+    void(*manage_)(void*, void*);                   // nullptr: trivially copyable
+    alignas(16) u8    buff_[N];
+};
 
-    union
-    {
-        ILambda*    data_;
-        u8          buff_[32];
-    };
+/*!
+ * non-owning callable reference, copyable, never allocates.
+ * the callable must outlive the delegate_ref.
+ */
+template<class R, class ...T>
+class delegate_ref<R(T...)> final
+{
+public:
+    template<class F, class = $when<!$is<delegate_ref, Tmutable<Tvalue<F>>>>>
+    delegate_ref(F&& f) noexcept {
+        using Tfunc = typename ns_delegate::_Tfunc<Tvalue<F>>::U;
 
-    ILambda* lambda() {
-        if (buff_[sizeof(buff_) - 1] == 0) {
-            NMS_THROW(EInvalid{});
-        }
-        if (buff_[sizeof(buff_) - 1] < sizeof(buff_) ) {
-            return reinterpret_cast<ILambda*>(buff_);
+        if constexpr($is<void, Tfunc>) {
+            obj_    = const_cast<void*>(static_cast<const void*>(&f));
+            invoke_ = &ns_delegate::invokeInline<Tvalue<F>, R, T...>;
         }
         else {
-            return data_;
+            // functions are referenced by their address, which outlives the delegate_ref
+            const Tfunc func = f;
+            obj_    = reinterpret_cast<void*>(func);
+            invoke_ = &ns_delegate::invokeFunc<Tfunc, R, T...>;
         }
     }
+
+    R operator()(T ...t) const {
+        return invoke_(obj_, static_cast<T&&>(t)...);
+    }
+
+private:
+    void*   obj_;
+    R     (*invoke_)(void*, T...);
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,152 @@
+#include <nms/test.h>
+#include <nms/core/hashmap.h>
+#include <nms/core/list.h>
+#include <nms/core/format.h>
+#include <nms/io/log.h>
+
+namespace nms
+{
+
+#pragma region unittest
+
+nms_test(hashmap) {
+    HashMap<String, u32> map;
+    map[StrView("one")] = 1;
+    map["two"]          = 2;
+    test::assert_eq(map.insert(String("three"), 3u), true);
+    test::assert_eq(map.insert(StrView("three"), 4u), false);
+    test::assert_eq(map.count(), 3u);
+
+    // lookup by StrView: no String is created
+    test::assert_eq(*map.find(StrView("three")), 3u);
+    test::assert_eq(map.find(StrView("four")) == nullptr, true);
+    test::assert_eq(map.contains(StrView("one")), true);
+
+    // copy, move
+    auto copy = map;
+    test::assert_eq(map.remove(StrView("one")), true);
+    test::assert_eq(map.remove(StrView("one")), false);
+    test::assert_eq(copy.count(), 3u);
+    test::assert_eq(*copy.find(StrView("one")), 1u);
+
+    HashMap<String, u32> moved(static_cast<HashMap<String, u32>&&>(copy));
+    test::assert_eq(moved.count(), 3u);
+    test::assert_eq(copy.count(), 0u);
+    test::assert_eq(copy.contains(StrView("one")), false);
+
+    auto sum = 0u;
+    for (auto& entry : moved) {
+        sum += entry.val;
+    }
+    test::assert_eq(sum, 6u);
+
+    // copy-assign, move-assign over a non-empty map
+    copy = moved;
+    test::assert_eq(copy.count(), 3u);
+    test::assert_eq(*copy.find(StrView("three")), 3u);
+    map = static_cast<HashMap<String, u32>&&>(copy);
+    test::assert_eq(map.count(), 3u);
+    test::assert_eq(*map.find(StrView("one")), 1u);
+    test::assert_eq(copy.count(), 0u);
+
+    HashSet<Symbol> set;
+    test::assert_eq(set.insert(Symbol("nms.hashset.a")), true);
+    test::assert_eq(set.insert(Symbol("nms.hashset.a")), false);
+    test::assert_eq(set.contains(Symbol("nms.hashset.b")), false);
+}
+
+nms_test(hashmap_remove) {
+    // random insert/remove, checked against a flag table
+    static const u32 $count = 4096;
+
+    HashMap<u32, u32> map;
+    bool exists[$count] = {};
+    auto cnt  = 0u;
+    auto seed = 1u;
+    for (u32 i = 0; i < 200000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const auto key = (seed >> 8) % $count;
+        if ((seed >> 4) % 3 == 0) {
+            test::assert_eq(map.remove(key), exists[key]);
+            cnt -= exists[key] ? 1 : 0;
+            exists[key] = false;
+        }
+        else {
+            test::assert_eq(map.insert(key, key * 2), !exists[key]);
+            cnt += exists[key] ? 0 : 1;
+            exists[key] = true;
+        }
+    }
+    test::assert_eq(map.count(), cnt);
+
+    auto errs = 0u;
+    for (u32 key = 0; key < $count; ++key) {
+        const auto val = map.find(key);
+        errs += (val != nullptr) == exists[key] ? 0 : 1;
+        errs += val == nullptr || *val == key * 2 ? 0 : 1;
+    }
+    test::assert_eq(errs, 0u);
+
+    map.clear();
+    test::assert_eq(map.count(), 0u);
+    test::assert_eq(map.contains(0u), false);
+}
+
+nms_test(hashmap_bench) {
+    static const u32 $count = 1024 * 1024;
+
+    HashMap<u32, u32> map;
+    const auto t0 = clock();
+    for (u32 i = 0; i < $count; ++i) {
+        map[i * 7u] = i;
+    }
+    const auto t1 = clock();
+    auto hits = 0u;
+    for (u32 i = 0; i < $count; ++i) {
+        hits += map.contains(i * 7u) ? 1 : 0;
+        hits += map.contains(i * 7u + 1) ? 1 : 0;
+    }
+    const auto t2 = clock();
+    for (u32 i = 0; i < $count; ++i) {
+        map.remove(i * 7u);
+    }
+    const auto t3 = clock();
+
+    test::assert_eq(hits, $count);
+    test::assert_eq(map.count(), 0u);
+    io::log::info("nms.HashMap: {} u32, insert {:.1f} ns, find(hit+miss) {:.1f} ns, remove {:.1f} ns",
+        $count, (t1 - t0) * 1e9 / $count, (t2 - t1) * 1e9 / $count, (t3 - t2) * 1e9 / $count);
+
+    // string keys: hash map vs linear scan
+    static const u32 $keys = 1000;
+    List<String>        list;
+    HashSet<String>     set;
+    for (u32 i = 0; i < $keys; ++i) {
+        list.append(format("nms.key.{}", i));
+        set.insert(list[i]);
+    }
+
+    auto found = 0u;
+    const auto t4 = clock();
+    for (u32 i = 0; i < $keys; ++i) {
+        for (auto& str : list) {
+            if (StrView(str) == StrView(list[i])) {
+                ++found;
+                break;
+            }
+        }
+    }
+    const auto t5 = clock();
+    for (u32 i = 0; i < $keys; ++i) {
+        found += set.contains(StrView(list[i])) ? 1 : 0;
+    }
+    const auto t6 = clock();
+
+    test::assert_eq(found, $keys * 2);
+    io::log::info("nms.HashSet: {} strings, find: scan {:.1f} ns, hash {:.1f} ns",
+        $keys, (t5 - t4) * 1e9 / $keys, (t6 - t5) * 1e9 / $keys);
+}
+
+#pragma endregion
+
+}
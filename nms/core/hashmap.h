@@ -0,0 +1,557 @@
+#pragma once
+
+#include <nms/core/memory.h>
+#include <nms/core/string.h>
+#include <nms/core/symbol.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define NMS_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef NMS_CC_MSVC
+#include <intrin.h>
+#endif
+
+namespace nms
+{
+
+#pragma region hash
+/* mix the bits of an integer (murmur3 finalizer) */
+constexpr u64 hashMix(u64 x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+/*!
+ * hash and equality of the key of HashMap/HashSet.
+ * specialize it for other types.
+ */
+template<class T>
+struct Hash
+{
+    static u64 hash(const T& x) {
+        return hashMix(u64(x));
+    }
+
+    template<class U>
+    static bool equal(const T& a, const U& b) {
+        return a == b;
+    }
+};
+
+template<class T>
+struct Hash<T*>
+{
+    static u64 hash(const T* x) {
+        return hashMix(u64(reinterpret_cast<decltype(sizeof(0))>(x)));
+    }
+
+    static bool equal(const T* a, const T* b) {
+        return a == b;
+    }
+};
+
+/* strings: lookup by any type which converts to StrView */
+template<>
+struct Hash<StrView>
+{
+    static u64 hash(StrView x) {
+        return strhash(x);
+    }
+
+    static bool equal(StrView a, StrView b) {
+        return a == b;
+    }
+};
+
+template<u32 N>
+struct Hash<TString<char, N>>
+    : Hash<StrView>
+{};
+
+template<>
+struct Hash<Symbol>
+{
+    static u64 hash(Symbol x) {
+        return hashMix(x.hash());
+    }
+
+    static bool equal(Symbol a, Symbol b) {
+        return a == b;
+    }
+};
+#pragma endregion
+
+#pragma region hashtable
+template<class K, class V>
+struct HashEntry
+{
+    K   key;
+    V   val;
+
+    template<class UK, class UV>
+    HashEntry(UK&& k, UV&& v)
+        : key(fwd<UK>(k)), val(fwd<UV>(v))
+    {}
+};
+
+/*!
+ * flat open-addressing hash table, the storage of HashMap and HashSet.
+ *
+ * each slot has a control byte: 0x80 if empty, or the low 7 bits of the hash.
+ * probing is linear, 16 control bytes are compared at once (SSE2),
+ * the first 16 control bytes are mirrored after the end, so a group may start at any slot.
+ * remove shifts the following entries back, so there are no tombstones.
+ */
+template<class K, class E>
+class HashTable
+{
+public:
+    using Tkey   = K;
+    using Tentry = E;
+    using Tsize  = usize;
+
+    constexpr static const Tsize $group  = 16;
+    constexpr static const u8    $empty  = 0x80;
+
+    class Iterator
+    {
+    public:
+        Iterator(const u8* ctrl, E* slots, Tsize idx, Tsize cap)
+            : ctrl_(ctrl), slots_(slots), idx_(idx), cap_(cap) {
+            skip();
+        }
+
+        E& operator*() const {
+            return slots_[idx_];
+        }
+
+        E* operator->() const {
+            return &slots_[idx_];
+        }
+
+        Iterator& operator++() {
+            ++idx_;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return idx_ == rhs.idx_;
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return idx_ != rhs.idx_;
+        }
+
+    private:
+        const u8*   ctrl_;
+        E*          slots_;
+        Tsize       idx_;
+        Tsize       cap_;
+
+        void skip() {
+            while (idx_ < cap_ && ctrl_[idx_] == $empty) {
+                ++idx_;
+            }
+        }
+    };
+
+#pragma region constructor
+    constexpr HashTable() noexcept
+    {}
+
+    ~HashTable() {
+        release();
+    }
+
+    HashTable(HashTable&& rhs) noexcept
+        : ctrl_(rhs.ctrl_), slots_(rhs.slots_), count_(rhs.count_), capacity_(rhs.capacity_) {
+        rhs.ctrl_       = nullptr;
+        rhs.slots_      = nullptr;
+        rhs.count_      = 0;
+        rhs.capacity_   = 0;
+    }
+
+    HashTable(const HashTable& rhs) {
+        if (rhs.count_ == 0) {
+            return;
+        }
+        reserve(rhs.count_);
+        for (auto& entry : rhs) {
+            const auto hash = Hash<K>::hash(keyOf(entry));
+            new(&slots_[insertSlot(hash)])E(entry);
+            ++count_;
+        }
+    }
+
+    HashTable& operator=(HashTable&& rhs) noexcept {
+        if (this != &rhs) {
+            HashTable tmp(static_cast<HashTable&&>(rhs));
+            swapWith(tmp);
+        }
+        return *this;
+    }
+
+    /* copy and swap: *this is unchanged if a copy throws */
+    HashTable& operator=(const HashTable& rhs) {
+        if (this != &rhs) {
+            HashTable tmp(rhs);
+            swapWith(tmp);
+        }
+        return *this;
+    }
+#pragma endregion
+
+#pragma region property
+    Tsize count() const noexcept {
+        return count_;
+    }
+
+    Tsize capacity() const noexcept {
+        return capacity_;
+    }
+
+    bool isEmpty() const noexcept {
+        return count_ == 0;
+    }
+
+    Iterator begin() const {
+        return { ctrl_, slots_, 0, capacity_ };
+    }
+
+    Iterator end() const {
+        return { ctrl_, slots_, capacity_, capacity_ };
+    }
+#pragma endregion
+
+#pragma region method
+    template<class Q>
+    bool contains(const Q& key) const {
+        return lookup(key) != capacity_;
+    }
+
+    /* remove the entry, returns false if not found */
+    template<class Q>
+    bool remove(const Q& key) {
+        const auto idx = lookup(key);
+        if (idx == capacity_) {
+            return false;
+        }
+        erase(idx);
+        return true;
+    }
+
+    /* remove all entries, the storage is kept */
+    void clear() {
+        for (Tsize i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] != $empty) {
+                slots_[i].~E();
+            }
+        }
+        for (Tsize i = 0; ctrl_ != nullptr && i < capacity_ + $group; ++i) {
+            ctrl_[i] = $empty;
+        }
+        count_ = 0;
+    }
+
+    /* make room for `cnt` entries without rehash */
+    void reserve(Tsize cnt) {
+        auto cap = capacity_ == 0 ? $group : capacity_;
+        while (cnt > maxCount(cap)) {
+            cap *= 2;
+        }
+        if (cap != capacity_) {
+            rehash(cap);
+        }
+    }
+#pragma endregion
+
+protected:
+    u8*     ctrl_       = nullptr;
+    E*      slots_      = nullptr;
+    Tsize   count_      = 0;
+    Tsize   capacity_   = 0;        // power of 2, or 0
+
+    static const K& keyOf(const K& key) {
+        return key;
+    }
+
+    template<class V>
+    static const K& keyOf(const HashEntry<K, V>& entry) {
+        return entry.key;
+    }
+
+    /* max load factor: 3/4, keeps the linear probe runs short */
+    static Tsize maxCount(Tsize cap) {
+        return cap - cap / 4;
+    }
+
+    static u8 tagOf(u64 hash) {
+        return u8(hash & 0x7F);
+    }
+
+    Tsize homeOf(u64 hash) const {
+        return Tsize(hash >> 7) & (capacity_ - 1);
+    }
+
+#ifdef NMS_HASH_SSE2
+    /* bit i is set if ctrl[i] == tag */
+    static u32 match(const u8* ctrl, u8 tag) {
+        const auto group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(tag)))));
+    }
+
+    /* bit i is set if ctrl[i] is empty */
+    static u32 matchEmpty(const u8* ctrl) {
+        const auto group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return u32(_mm_movemask_epi8(group));
+    }
+#else
+    static u32 match(const u8* ctrl, u8 tag) {
+        auto mask = 0u;
+        for (u32 i = 0; i < $group; ++i) {
+            mask |= (ctrl[i] == tag ? 1u : 0u) << i;
+        }
+        return mask;
+    }
+
+    static u32 matchEmpty(const u8* ctrl) {
+        auto mask = 0u;
+        for (u32 i = 0; i < $group; ++i) {
+            mask |= u32(ctrl[i] >> 7) << i;
+        }
+        return mask;
+    }
+#endif
+
+    static u32 lowBit(u32 mask) {
+#ifdef NMS_CC_MSVC
+        unsigned long idx;
+        _BitScanForward(&idx, mask);
+        return u32(idx);
+#else
+        return u32(__builtin_ctz(mask));
+#endif
+    }
+
+    /* index of the entry, or capacity_ if not found */
+    template<class Q>
+    Tsize lookup(const Q& key) const {
+        if (count_ == 0) {
+            return capacity_;
+        }
+
+        const auto hash = Hash<K>::hash(key);
+        const auto tag  = tagOf(hash);
+        const auto mask = capacity_ - 1;
+
+        for (auto pos = homeOf(hash); ; pos = (pos + $group) & mask) {
+            const auto empty = matchEmpty(ctrl_ + pos);
+
+            // entries after the first empty slot are not in this probe sequence
+            auto found = match(ctrl_ + pos, tag);
+            if (empty != 0) {
+                found &= (empty & (0u - empty)) - 1;
+            }
+            for (; found != 0; found &= found - 1) {
+                const auto idx = (pos + lowBit(found)) & mask;
+                if (Hash<K>::equal(keyOf(slots_[idx]), key)) {
+                    return idx;
+                }
+            }
+            if (empty != 0) {
+                return capacity_;
+            }
+        }
+    }
+
+    /* index of the entry, or a new slot (not constructed) if not found */
+    template<class Q>
+    Tsize locate(const Q& key, bool& found) {
+        auto idx = lookup(key);
+        if (idx != capacity_) {
+            found = true;
+            return idx;
+        }
+
+        found = false;
+        if (count_ + 1 > maxCount(capacity_)) {
+            reserve(count_ + 1);
+        }
+        idx = insertSlot(Hash<K>::hash(key));
+        ++count_;
+        return idx;
+    }
+
+    /* find the first empty slot in the probe sequence, and mark it full */
+    Tsize insertSlot(u64 hash) {
+        const auto mask = capacity_ - 1;
+
+        for (auto pos = homeOf(hash); ; pos = (pos + $group) & mask) {
+            const auto empty = matchEmpty(ctrl_ + pos);
+            if (empty != 0) {
+                const auto idx = (pos + lowBit(empty)) & mask;
+                setCtrl(idx, tagOf(hash));
+                return idx;
+            }
+        }
+    }
+
+    void setCtrl(Tsize idx, u8 val) {
+        ctrl_[idx] = val;
+        if (idx < $group) {
+            ctrl_[capacity_ + idx] = val;
+        }
+    }
+
+    /* remove by backward shift: move the following entries to fill the hole */
+    void erase(Tsize idx) {
+        const auto mask = capacity_ - 1;
+
+        slots_[idx].~E();
+        for (auto pos = (idx + 1) & mask; ctrl_[pos] != $empty; pos = (pos + 1) & mask) {
+            const auto home = homeOf(Hash<K>::hash(keyOf(slots_[pos])));
+
+            // the entry may move to the hole, if the hole is between its home and itself
+            if (((pos - home) & mask) >= ((pos - idx) & mask)) {
+                new(&slots_[idx])E(static_cast<E&&>(slots_[pos]));
+                slots_[pos].~E();
+                setCtrl(idx, ctrl_[pos]);
+                idx = pos;
+            }
+        }
+        setCtrl(idx, $empty);
+        --count_;
+    }
+
+    void rehash(Tsize cap) {
+        const auto old_ctrl  = ctrl_;
+        const auto old_slots = slots_;
+        const auto old_cap   = capacity_;
+
+        ctrl_       = mnew<u8>(cap + $group);
+        slots_      = mnew<E>(cap);
+        capacity_   = cap;
+        for (Tsize i = 0; i < cap + $group; ++i) {
+            ctrl_[i] = $empty;
+        }
+
+        for (Tsize i = 0; i < old_cap; ++i) {
+            if (old_ctrl[i] != $empty) {
+                auto& entry = old_slots[i];
+                new(&slots_[insertSlot(Hash<K>::hash(keyOf(entry)))])E(static_cast<E&&>(entry));
+                entry.~E();
+            }
+        }
+
+        if (old_ctrl != nullptr) {
+            mdel(old_ctrl);
+            mdel(old_slots);
+        }
+    }
+
+    void swapWith(HashTable& rhs) noexcept {
+        nms::swap(ctrl_,     rhs.ctrl_);
+        nms::swap(slots_,    rhs.slots_);
+        nms::swap(count_,    rhs.count_);
+        nms::swap(capacity_, rhs.capacity_);
+    }
+
+    void release() {
+        if (ctrl_ == nullptr) {
+            return;
+        }
+        clear();
+        mdel(ctrl_);
+        mdel(slots_);
+        ctrl_       = nullptr;
+        slots_      = nullptr;
+        capacity_   = 0;
+    }
+};
+#pragma endregion
+
+#pragma region hashmap
+/*!
+ * hash map.
+ * keys may be looked up by any type which Hash<K> accepts, e.g. StrView for String keys.
+ * inserting or removing may move the entries.
+ */
+template<class K, class V>
+class HashMap
+    : public HashTable<K, HashEntry<K, V>>
+{
+    using base = HashTable<K, HashEntry<K, V>>;
+
+public:
+    using Tkey   = K;
+    using Tvalue = V;
+
+    /* the value of `key`, or nullptr if not found */
+    template<class Q>
+    V* find(const Q& key) {
+        const auto idx = base::lookup(key);
+        return idx == base::capacity_ ? nullptr : &base::slots_[idx].val;
+    }
+
+    template<class Q>
+    const V* find(const Q& key) const {
+        const auto idx = base::lookup(key);
+        return idx == base::capacity_ ? nullptr : &base::slots_[idx].val;
+    }
+
+    /* the value of `key`, inserted with V() if not found */
+    template<class Q>
+    V& operator[](const Q& key) {
+        auto found = false;
+        const auto idx = base::locate(key, found);
+        if (!found) {
+            new(&base::slots_[idx])HashEntry<K, V>(K(key), V());
+        }
+        return base::slots_[idx].val;
+    }
+
+    /* insert if not found, returns false if `key` exists (the value is not changed) */
+    template<class Q, class U>
+    bool insert(const Q& key, U&& val) {
+        auto found = false;
+        const auto idx = base::locate(key, found);
+        if (!found) {
+            new(&base::slots_[idx])HashEntry<K, V>(K(key), fwd<U>(val));
+        }
+        return !found;
+    }
+};
+#pragma endregion
+
+#pragma region hashset
+/* hash set */
+template<class K>
+class HashSet
+    : public HashTable<K, K>
+{
+    using base = HashTable<K, K>;
+
+public:
+    using Tkey = K;
+
+    /* insert if not found, returns false if `key` exists */
+    template<class Q>
+    bool insert(const Q& key) {
+        auto found = false;
+        const auto idx = base::locate(key, found);
+        if (!found) {
+            new(&base::slots_[idx])K(key);
+        }
+        return !found;
+    }
+};
+#pragma endregion
+
+}
@@ -1,6 +1,9 @@
 #include <nms/test.h>
 #include <nms/core/list.h>
+#include <nms/core/string.h>
+#include <nms/core/format.h>
 #include <nms/io/console.h>
+#include <nms/io/log.h>
 
 namespace nms
 {
@@ -15,6 +18,65 @@ nms_test(list) {
     io::console::writeln("list = {}", list);
 }
 
+nms_test(list_move) {
+    // non-trivial elements: moved when the list grows
+    List<String> strs;
+    for (u32 i = 0; i < 100; ++i) {
+        strs.append(format("str{}", i));
+    }
+    test::assert_eq(strs.count(), 100u);
+    test::assert_eq(StrView(strs[99]), StrView("str99"));
+
+    // inline storage: elements are moved, not the pointer
+    List<u32, 8> small;
+    small.append(1u);
+    small.append(2u);
+    List<u32> heap(static_cast<List<u32>&&>(small));
+    test::assert_eq(heap.count(), 2u);
+    test::assert_eq(heap[1], 2u);
+
+    String str = format("{}-{}", 1, 2);
+    test::assert_eq(StrView(str), StrView("1-2"));
+
+    // move assign: old storage is released
+    List<u32> other;
+    other.appends(100, 7u);
+    other = static_cast<List<u32>&&>(heap);
+    test::assert_eq(other.count(), 2u);
+}
+
+nms_test(list_append) {
+    static const u32 count = 1024 * 1024;
+
+    for (auto loop = 0; loop < 2; ++loop) {
+        List<u32> list;
+        auto grows  = 0u;
+        auto moves  = 0u;
+        auto ptr    = list.data();
+        auto cap    = list.capacity();
+
+        const auto t0 = clock();
+        for (u32 i = 0; i < count; ++i) {
+            list.append(i);
+            if (list.capacity() != cap) {
+                ++grows;
+                moves += list.data() != ptr ? 1 : 0;
+                cap = list.capacity();
+                ptr = list.data();
+            }
+        }
+        const auto t1 = clock();
+
+        test::assert_eq(list.count(), count);
+        test::assert_eq(list[count - 1], count - 1);
+
+        if (loop > 0) {
+            io::log::info("nms.list: append {} u32: {:.3f} ms, {:.1f} M/s, grow {} times, moved {} times",
+                count, (t1 - t0) * 1000, count / (t1 - t0) / 1e6, grows, moves);
+        }
+    }
+}
+
 #pragma endregion
 
-}
\ No newline at end of file
+}
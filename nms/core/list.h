@@ -16,6 +16,22 @@ class Path;
 template<class T, u32 S = 0>
 class List;
 
+/*!
+ * growth policy of List.
+ * specialize it to change how a list grows.
+ */
+template<class T>
+struct ListGrowth
+{
+    /* new capacity: at least `newcnt`, and grows geometrically (x1.5) */
+    static usize capacity(usize oldcap, usize newcnt) {
+        const auto maxcap = usize(~usize(0) - 31);
+        const auto geocap = oldcap < maxcap / 3 * 2 ? oldcap + oldcap / 2 : maxcap;
+        const auto reqcnt = newcnt > geocap ? newcnt : geocap;
+        return reqcnt < maxcap ? (reqcnt + 31) / 32 * 32 : reqcnt;
+    }
+};
+
 /* list */
 template<class T>
 class List<T, 0>: public View<T>
@@ -37,6 +53,13 @@ public:
             return;
         }
 
+        // borrowed storage is not owned
+        if (capacity_ == 0) {
+            size_ = 0;
+            data_ = nullptr;
+            return;
+        }
+
         for(Tsize i = 0; i < size_; ++i) {
             data_[i].~Tdata();
         }
@@ -56,10 +79,9 @@ public:
     }
 
     List(List&& rhs) noexcept
-        : base(rhs)
+        : List{}
     {
-        rhs.data_     = nullptr;
-        rhs.size_     = 0;
+        _move(rhs);
     }
 
     List(const List& rhs) noexcept
@@ -69,21 +91,18 @@ public:
     }
 
     List& operator=(List&& rhs) noexcept {
-        base::operator=(rhs);
-        rhs.data_ = nullptr;
-        rhs.size_ = 0;
+        if (this != &rhs) {
+            _clear();
+            _move(rhs);
+        }
         return *this;
     }
 
     List& operator=(const List& rhs) noexcept {
-        // clear
-        for (Tsize i = 0; i < size_; ++i) {
-            data_[i].~Tdata();
+        if (this != &rhs) {
+            _clear();
+            appends(rhs.data(), rhs.count());
         }
-        size_ = 0;
-
-        // append
-        appends(rhs.data(), rhs.count());
         return *this;
     }
 #pragma endregion
@@ -97,33 +116,69 @@ public:
     Tsize capacity() const noexcept {
         return capacity_;
     }
+
+    /* test if the storage is borrowed (see borrow) */
+    bool isBorrowed() const noexcept {
+        return data_ != nullptr && capacity_ == 0;
+    }
+
+    /*!
+     * make a list over external storage.
+     * the storage is not freed by the list, and will be copied when the list grows.
+     */
+    static List borrow(Tdata* data, Tsize count) noexcept {
+        List list;
+        list.data_      = data;
+        list.size_      = count;
+        list.capacity_  = 0;
+        return list;
+    }
 #pragma endregion
 
 #pragma region method
+    /*! reserve the storage, grows by ListGrowth */
     List& reserve(Tsize newcnt) {
         const auto oldcnt = base::size_;
         const auto oldcap = capacity_;
-        if (newcnt > oldcap) {
-            // caculate new capicity
-            newcnt = newcnt > oldcap + oldcap/16 ? newcnt : oldcap + oldcap/16;
-            const auto newcap = (newcnt +31) / 32 * 32;
-            const auto olddat = data_;
+        const auto oldlen = oldcap != 0 ? oldcap : oldcnt;   // borrowed storage: capacity=0
+        if (newcnt <= oldlen) {
+            return *this;
+        }
+
+        const auto newcap = Tsize(ListGrowth<Tdata>::capacity(oldcap, newcnt));
+        const auto olddat = data_;
+        const auto isheap = olddat != nullptr && olddat != buff() && oldcap != 0;
+
+        // relocatable: realloc, may grow in place without copy
+        if ($is_relocatable<Tdata> && isheap) {
+            data_     = mrenew(olddat, newcap);
             capacity_ = newcap;
+            return *this;
+        }
 
-            // realloc
-            const auto newdat = mnew<Tdata>(newcap);
-            data_ = newdat;
+        const auto newdat = mnew<Tdata>(newcap);
 
-            // move olddat -> newdat
-            for(Tsize i = 0; i < oldcnt; ++i) {
+        // move olddat -> newdat
+        if ($is_relocatable<Tdata> && oldcap != 0) {
+            mcpy(reinterpret_cast<u8*>(newdat), reinterpret_cast<const u8*>(olddat), u64(oldcnt) * sizeof(Tdata));
+        }
+        else {
+            for (Tsize i = 0; i < oldcnt; ++i) {
                 new (&newdat[i])Tdata(static_cast<Tdata&&>(olddat[i]));
             }
-
-            // free old data
-            if (olddat!=nullptr && olddat!=buff()) {
-                mdel(olddat);
+            if (oldcap != 0) {
+                for (Tsize i = 0; i < oldcnt; ++i) {
+                    olddat[i].~Tdata();
+                }
             }
-            
+        }
+
+        data_     = newdat;
+        capacity_ = newcap;
+
+        // free old data
+        if (isheap) {
+            mdel(olddat);
         }
         return *this;
     }
@@ -150,6 +205,11 @@ public:
     template<class U>
     List& appends(const U dat[], Tsize cnt) {
         reserve(size_ + cnt);
+        if ($is<Tmutable<U>, Tdata> && $is_trivially_copyable<Tdata>) {
+            mcpy(reinterpret_cast<u8*>(data_ + size_), reinterpret_cast<const u8*>(dat), u64(cnt) * sizeof(Tdata));
+            size_ += cnt;
+            return *this;
+        }
         for (Tsize i = 0; i < cnt; ++i) {
             new(&data_[base::size_++])Tdata(dat[i]);
         }
@@ -191,6 +251,52 @@ protected:
         return reinterpret_cast<const Tdata*>(&capacity_+1);
     }
 
+    /* destroy the elements, keep the storage */
+    void _clear() {
+        if (capacity_ != 0) {
+            for (Tsize i = 0; i < size_; ++i) {
+                data_[i].~Tdata();
+            }
+        }
+        else {
+            data_ = nullptr;    // borrowed
+        }
+        size_ = 0;
+    }
+
+    /* take the elements of rhs: steal heap storage, move the elements of inline storage */
+    void _move(List& rhs) {
+        if (rhs.data_ == nullptr) {
+            return;
+        }
+
+        if (rhs.data_ == rhs.buff() && rhs.capacity_ != 0) {
+            reserve(size_ + rhs.size_);
+            if ($is_trivially_copyable<Tdata>) {
+                mcpy(reinterpret_cast<u8*>(data_ + size_), reinterpret_cast<const u8*>(rhs.data_), u64(rhs.size_) * sizeof(Tdata));
+                size_    += rhs.size_;
+                rhs.size_ = 0;
+                return;
+            }
+            for (Tsize i = 0; i < rhs.size_; ++i) {
+                new(&data_[size_++]) Tdata(static_cast<Tdata&&>(rhs.data_[i]));
+                rhs.data_[i].~Tdata();
+            }
+            rhs.size_ = 0;
+            return;
+        }
+
+        if (data_ != nullptr && data_ != buff() && capacity_ != 0) {
+            mdel(data_);
+        }
+        data_       = rhs.data_;
+        size_       = rhs.size_;
+        capacity_   = rhs.capacity_;
+        rhs.data_       = nullptr;
+        rhs.size_       = 0;
+        rhs.capacity_   = 0;
+    }
+
     template<class File>
     static void saveFile(const List& list, File& file) {
         const auto info = list.info();
@@ -245,20 +351,13 @@ public:
     }
 
     List(List&& rhs) noexcept
-        : base{ static_cast<base&&>(rhs) }
+        : List{}
     {
-        if (data() == rhs.buff()) {
-            dat2buf();
-        }
+        base::operator=(static_cast<base&&>(rhs));
     }
 
     List& operator=(List&& rhs) noexcept {
-        if (this != &rhs) {
-            base::operator=(static_cast<base&&>(rhs));
-            if (rhs.data() == rhs.buff()) {
-                dat2buf();
-            }
-        }
+        base::operator=(static_cast<base&&>(rhs));
         return *this;
     }
 #pragma endregion
@@ -283,17 +382,11 @@ protected:
     using   base::size_;
     using   base::capacity_;
     u8      buff_[sizeof(Tdata)*$capicity] = {};
-
-    void dat2buf() {
-        auto buf = buff();
-        auto dat = data();
-        for (Tsize i = 0; i < size_; ++i) {
-            new(&buf[i]) Tdata(static_cast<Tdata&&>(dat[i]));
-        }
-        data_ = buf;
-    }
-
 };
 
+/* heap storage does not point into the list itself */
+template<class T>
+constexpr bool $is_relocatable<List<T, 0>> = true;
+
 }
 
@@ -15,9 +15,12 @@ extern "C" {
     };
 
     enum {
-        MAP_SHARED = 0x1
+        MAP_SHARED  = 0x1,
+        MAP_PRIVATE = 0x2
     };
 
+    static void* const MAP_FAILED = reinterpret_cast<void*>(-1);
+
     /*!
      * Microsoft Memory Management Functions
      * https://msdn.microsoft.com/en-us/library/aa366781(v=vs.85).aspx
@@ -37,16 +40,22 @@ extern "C" {
         const u32 size_high = (size >> 32);
         const u32 size_low = (size << 32) >> 32;
 
+        const i32 page_writecopy = 0x08;
+        const auto page_prot = (flags & MAP_PRIVATE) ? page_writecopy : prot;
+
         auto hfile = reinterpret_cast<void*>(_get_osfhandle(fid));
-        auto hmmap = CreateFileMappingA(hfile, nullptr, prot, size_high, size_low, nullptr);
+        auto hmmap = CreateFileMappingA(hfile, nullptr, page_prot, size_high, size_low, nullptr);
 
         // view
         const u32 offset_high = (offset >> 32);
         const u32 offset_low = (offset << 32) >> 32;
         const u32 file_map_write = 0x0002;
-        auto ptr = MapViewOfFile(hmmap, file_map_write, offset_high, offset_low, size);
+        const u32 file_map_copy  = 0x0001;
+        const auto map_access = (flags & MAP_PRIVATE) ? file_map_copy : file_map_write;
+        auto ptr = MapViewOfFile(hmmap, map_access, offset_high, offset_low, size);
+        CloseHandle(hmmap);
         if (ptr == nullptr) {
-            return nullptr;
+            return MAP_FAILED;
         }
 
         return ptr;
@@ -95,6 +104,19 @@ NMS_API void* _mnew(u64 size) {
     return ptr;
 }
 
+NMS_API void* _mrenew(void* dat, u64 size) {
+    if (size == 0) {
+        ::free(dat);
+        return nullptr;
+    }
+
+    const auto ptr = ::realloc(dat, size);
+    if (ptr == nullptr) {
+        NMS_THROW(EBadAlloc{});
+    }
+    return ptr;
+}
+
 NMS_API void  _mdel(void* ptr) {
     /*
      * @see: http://en.cppreference.com/w/c/memory/free
@@ -103,6 +125,34 @@ NMS_API void  _mdel(void* ptr) {
     ::free(ptr);
 }
 
+NMS_API void* _mnew_align(u64 size, u64 align) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+#ifdef NMS_OS_WINDOWS
+    const auto ptr = ::_aligned_malloc(size, align);
+#else
+    // posix_memalign: align should be at least sizeof(void*)
+    void* ptr = nullptr;
+    if (::posix_memalign(&ptr, align < sizeof(void*) ? sizeof(void*) : align, size) != 0) {
+        ptr = nullptr;
+    }
+#endif
+    if (ptr == nullptr) {
+        NMS_THROW(EBadAlloc{});
+    }
+    return ptr;
+}
+
+NMS_API void _mdel_align(void* ptr) {
+#ifdef NMS_OS_WINDOWS
+    ::_aligned_free(ptr);
+#else
+    ::free(ptr);
+#endif
+}
+
 NMS_API void _mzero(void* dat, u64 size) {
     ::memset(dat, 0, size);
 }
@@ -132,9 +182,13 @@ NMS_API u64 msize(const void* ptr) {
 }
 
 
-NMS_API void* mmap(int fid, u64 size) {
-    ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fid, 0);
-    return nullptr;
+NMS_API void* mmap(int fid, u64 size, bool shared) {
+    const auto flags = shared ? MAP_SHARED : MAP_PRIVATE;
+    const auto ptr   = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fid, 0);
+    if (ptr == MAP_FAILED) {
+        NMS_THROW(ESystem{});
+    }
+    return ptr;
 }
 
 NMS_API void munmap(void* ptr, u64 size) {
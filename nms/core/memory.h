@@ -19,12 +19,22 @@ namespace nms
 
 NMS_API void* _mnew (u64 size);
 NMS_API void  _mdel (void* dat);
+NMS_API void* _mnew_align(u64 size, u64 align);
+NMS_API void  _mdel_align(void* dat);
+NMS_API void* _mrenew(void* dat, u64 size);
 NMS_API void  _mzero(void* dat, u64 size);
 NMS_API void  _mcpy (void* dst, const void* src, u64 size);
 NMS_API void  _mmov (void* dst, const void* src, u64 size);
 NMS_API int   _mcmp (const void* lhs, const void* rhs, u64 size);
 NMS_API u64   msize (const void* ptr);
 
+/*!
+ * map a file into memory.
+ * if shared is false, the mapping is copy-on-write, writes are not carried through to the file.
+ */
+NMS_API void* mmap  (int fid, u64 size, bool shared = true);
+NMS_API void  munmap(void* ptr, u64 size);
+
 class EBadAlloc: public IException
 {};
 
@@ -36,6 +46,43 @@ T* mnew(u64 n){
     return ptr;
 }
 
+/* alignment of a cache line, and of a page */
+constexpr static const u64 $align_line = 64;
+constexpr static const u64 $align_page = 4096;
+
+/*!
+ * aligned allocation, `align` should be a power of 2.
+ * the memory should be released by mdel_align.
+ */
+template<class T>
+T* mnew_align(u64 n, u64 align = $align_line) {
+    const auto size = n * sizeof(T);
+    const auto ptr  = static_cast<T*>(_mnew_align(size, align < alignof(T) ? alignof(T) : align));
+    return ptr;
+}
+
+/* aligned deallocation */
+template<class T>
+__forceinline void mdel_align(T* dat) {
+    _mdel_align(dat);
+}
+
+/* test if `ptr` is aligned to `align` bytes */
+__forceinline bool maligned(const void* ptr, u64 align) {
+    return (reinterpret_cast<decltype(sizeof(0))>(ptr) & (align - 1)) == 0;
+}
+
+/*!
+ * reallocation, the contents are moved by raw memory copy.
+ * large blocks are remapped in place by the system allocator when possible.
+ */
+template<class T>
+T* mrenew(T* dat, u64 n) {
+    const auto size = n * sizeof(T);
+    const auto ptr  = static_cast<T*>(_mrenew(dat, size));
+    return ptr;
+}
+
 /* deallocation */
 template<class T>
 __forceinline void mdel(T* dat) {
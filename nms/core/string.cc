@@ -1,6 +1,7 @@
 #include <nms/core.h>
 #include <nms/core/string.h>
 #include <nms/test.h>
+#include <nms/io/log.h>
 
 namespace nms
 {
@@ -13,6 +14,36 @@ NMS_API u32 strlen(const char* s) {
     return len;
 }
 
+NMS_API u64 strhash(StrView s) {
+    static const u64 $k = 0x9E3779B97F4A7C15ull;
+
+    auto ptr = s.data();
+    auto len = s.count();
+    auto val = u64(len) * $k;
+
+    // 8 chars a time
+    for (; len >= 8; ptr += 8, len -= 8) {
+        u64 word;
+        ::memcpy(&word, ptr, 8);
+        val = (val ^ word) * $k;
+        val ^= val >> 29;
+    }
+    if (len != 0) {
+        u64 word = 0;
+        ::memcpy(&word, ptr, len);
+        val = (val ^ word) * $k;
+        val ^= val >> 29;
+    }
+
+    // finalize: murmur3 fmix64
+    val ^= val >> 33;
+    val *= 0xFF51AFD7ED558CCDull;
+    val ^= val >> 33;
+    val *= 0xC4CEB9FE1A85EC53ull;
+    val ^= val >> 33;
+    return val;
+}
+
 /* --- split --- */
 static bool contains(char c, StrView str) {
     const auto n = str.count();
@@ -47,7 +78,54 @@ NMS_API List<StrView> split(StrView str, StrView delimiters) {
 
 #pragma region unittest
 nms_test(string) {
-    
+    // short: inline
+    String a("hello");
+    test::assert_eq(a.isInline(), true);
+    test::assert_eq(a.capacity(), String::$sso);
+    test::assert_eq(StrView(a.cstr(), 5), StrView("hello"));
+
+    // long: heap
+    String b("0123456789abcdef0123456789abcdef");
+    test::assert_eq(b.isInline(), false);
+
+    // move: steal heap storage, copy inline chars
+    const auto ptr = b.data();
+    String c(static_cast<String&&>(b));
+    test::assert_eq(c.data(), ptr);
+    String d(static_cast<String&&>(a));
+    test::assert_eq(d.isInline(), true);
+    test::assert_eq(StrView(d), StrView("hello"));
+
+    // grows out of inline storage
+    for (auto i = 0; i < 30; ++i) {
+        d += '!';
+    }
+    test::assert_eq(d.isInline(), false);
+    test::assert_eq(d.count(), 35u);
+
+    // fixed capacity string extends the inline storage
+    U8String<32> e;
+    test::assert_eq(e.capacity(), String::$sso + 32);
+    e.appends(String::$sso + 32, 'x');
+    test::assert_eq(e.isInline(), true);
+}
+
+nms_test(string_sso) {
+    static const u32 count = 1024 * 1024;
+
+    List<String> keys;
+    keys.reserve(count);
+
+    const auto t0 = clock();
+    for (u32 i = 0; i < count; ++i) {
+        char tmp[16];
+        const auto len = snprintf(tmp, sizeof(tmp), "key%u", i);
+        keys.append(String(tmp, u32(len)));
+    }
+    const auto t1 = clock();
+
+    test::assert_eq(StrView(keys[count - 1]), StrView("key1048575"));
+    io::log::info("nms.String: make {} short strings: {:.3f} ms", count, (t1 - t0) * 1000);
 }
 #pragma endregion
 
@@ -9,6 +9,9 @@ namespace nms
 
 NMS_API u32 strlen(const char* s);
 
+/* hash of the chars, same chars -> same hash */
+NMS_API u64 strhash(StrView s);
+
 inline StrView mkStrView(const char* s) {
     return {s, strlen(s)};
 }
@@ -16,7 +19,11 @@ inline StrView mkStrView(const char* s) {
 template<class T, u32 N=0>
 class TString;
 
-/* TString */
+/*!
+ * TString
+ * short strings (less than 24 bytes) are stored inline, longer ones on heap.
+ * the inline storage follows `capacity_`, which is List::buff().
+ */
 template<class T>
 class TString<T, 0> : public List<T, 0>
 {
@@ -26,13 +33,22 @@ public:
     using Tsize = typename base::Tsize;
     using Tdata = typename base::Tdata;
 
+    /* inline capacity, with the null terminal */
+    constexpr static const Tsize $sso = 24 / sizeof(Tchar);
+
 public:
 #pragma region constructor
-    constexpr TString() noexcept = default;
+    constexpr TString() noexcept {
+        data_       = sso_;
+        capacity_   = $sso;
+        sso_[0]     = Tchar(0);
+    }
 
     ~TString() = default;
 
-    TString(const Tchar buff[], Tsize count) {
+    TString(const Tchar buff[], Tsize count)
+        : TString{}
+    {
         base::appends(buff, count);
     }
 
@@ -46,14 +62,27 @@ public:
         : TString(rhs.data(), rhs.count()) {
     }
 
+    /* heap storage is stolen, inline storage is copied */
     TString(TString&& rhs) noexcept
-        : base(static_cast<base&&>(rhs)) {
+        : TString{}
+    {
+        base::operator=(static_cast<base&&>(rhs));
     }
 
     TString(const TString& rhs) noexcept
         : TString(rhs.data(), rhs.count())
     { }
 
+    TString& operator=(TString&& rhs) noexcept {
+        base::operator=(static_cast<base&&>(rhs));
+        return *this;
+    }
+
+    TString& operator=(const TString& rhs) {
+        base::operator=(rhs);
+        return *this;
+    }
+
     TString& operator=(const View<const Tchar>& s) {
         base::size_ = 0;
         *this += s;
@@ -89,17 +118,18 @@ public:
 
     /*! returns a cstring (null terminal) */
     const Tchar* cstr() const {
-        if (data_ == nullptr) {
-            return nullptr;
-        }
-
-        if (data_[size_] != '\0') {
-            auto& self = const_cast<TString&>(*this);
-            self.reserve(size_+1);
-            self.data_[size_] = '\0';
+        auto& self = const_cast<TString&>(*this);
+        if (size_ >= capacity_) {
+            self.reserve(size_ + 1);
         }
+        self.data_[size_] = '\0';
         return data_;
     }
+
+    /*! test if the chars are stored inline */
+    bool isInline() const noexcept {
+        return data_ == base::buff();
+    }
 #pragma endregion 
 
     TString& operator+=(const View<const Tchar>& s) {
@@ -132,6 +162,7 @@ protected:
     using base::size_;
     using base::capacity_;
     using base::data_;
+    Tchar sso_[$sso];
 };
 
 /* TString */
@@ -144,13 +175,14 @@ public:
     using Tsize = typename base::Tsize;
     using Tdata = typename base::Tdata;
 
+    /* buff_ extends the inline storage of base */
     static const auto $capicity = N;
+    static_assert(sizeof(base) == sizeof(View<T>) + sizeof(Tchar) * base::$sso, "nms.TString: unexpect padding");
 
 public:
 #pragma region constructor
     constexpr TString() noexcept {
-        base::data_     = buff_;
-        base::capacity_ = $capicity;
+        base::capacity_ = base::$sso + $capicity;
     }
 
     ~TString()
@@ -173,25 +205,22 @@ public:
     {}
 
     TString(TString&& rhs) noexcept
-        : base(static_cast<base&&>(rhs))
+        : TString{}
     {
-        if (data_ == rhs.buff_) {
-            dat2buf();
-        }
+        base::operator=(static_cast<base&&>(rhs));
     }
 
     TString(const TString& rhs)
         : TString{ rhs.data(), rhs.count() }
     {}
 
-
     TString& operator=(TString&& rhs) noexcept {
-        if (this != &rhs) {
-            base::oeprator = (static_cast<base&&>(rhs));
-            if (data_ == rhs.buff_) {
-                dat2buf();
-            }
-        }
+        base::operator=(static_cast<base&&>(rhs));
+        return *this;
+    }
+
+    TString& operator=(const TString& rhs) {
+        base::operator=(rhs);
         return *this;
     }
     TString& operator=(const View<const Tchar>& s) {
@@ -219,15 +248,6 @@ protected:
     using base::capacity_;
     using base::data_;
     Tchar buff_[$capicity] = {};
-
-    void dat2buf() {
-        auto buf = buff_;
-        auto dat = data_;
-        for (Tsize i = 0; i < size_; ++i) {
-            new(&buf[i]) Tdata(static_cast<Tdata&&>(dat[i]));
-        }
-        data_ = buf;
-    }
 };
 
 /* split a TString into pieces */
@@ -0,0 +1,235 @@
+#include <nms/core/symbol.h>
+#include <nms/thread/mutex.h>
+#include <nms/thread/thread.h>
+#include <nms/util/arraylist.h>
+#include <nms/io/log.h>
+#include <nms/test.h>
+
+namespace nms
+{
+
+/* the global symbol table */
+class SymbolTable final
+    : public INocopyable
+{
+public:
+    SymbolTable() {
+        slots_.appends(1024, 0u);
+        intern("");
+    }
+
+    static SymbolTable& instance() {
+        // never destroyed: symbols may be used by other static objects
+        static auto table = new SymbolTable;
+        return *table;
+    }
+
+    u32 intern(StrView str) {
+        // Entry::len is u32
+        if (u64(str.count()) > u64(u32(-1))) {
+            NMS_THROW(EBadSize{});
+        }
+        const auto hash = u32(strhash(str));
+
+        thread::LockGuard lock(mutex_);
+        auto pos = probe(str, hash);
+        if (slots_[pos] != 0) {
+            return slots_[pos] - 1;
+        }
+
+        const auto id = u32(entries_.push(Entry{ store(str), u32(str.count()), hash }));
+        slots_[pos] = id + 1;
+
+        // load factor: 1/2
+        if (entries_.count() * 2 > slots_.count()) {
+            rehash();
+        }
+        return id;
+    }
+
+    bool find(StrView str, u32& id) {
+        const auto hash = u32(strhash(str));
+
+        thread::LockGuard lock(mutex_);
+        const auto pos = probe(str, hash);
+        if (slots_[pos] == 0) {
+            return false;
+        }
+        id = slots_[pos] - 1;
+        return true;
+    }
+
+    /* entries never move, read without lock */
+    StrView str(u32 id) const {
+        const auto& entry = entries_[id];
+        return { entry.ptr, entry.len };
+    }
+
+    u32 count() const {
+        return u32(entries_.count());
+    }
+
+private:
+    struct Entry
+    {
+        const char* ptr;
+        u32         len;
+        u32         hash;
+    };
+
+    static const u32 $chunk = 64 * 1024;
+
+    thread::Mutex                   mutex_;
+    ArrayList<Entry, 4096, 4096>    entries_;
+    List<u32>                       slots_;             // id + 1, 0: empty
+    char*                           chars_  = nullptr;  // current chunk
+    u32                             space_  = 0;        // free chars in chunk
+
+    /* the slot of `str`, or the empty slot to insert */
+    u32 probe(StrView str, u32 hash) const {
+        const auto mask = slots_.count() - 1;
+        for (auto pos = hash & mask; ; pos = (pos + 1) & mask) {
+            const auto slot = slots_[pos];
+            if (slot == 0) {
+                return pos;
+            }
+            const auto& entry = entries_[slot - 1];
+            if (entry.hash == hash && StrView{ entry.ptr, entry.len } == str) {
+                return pos;
+            }
+        }
+    }
+
+    void rehash() {
+        const auto cnt  = slots_.count() * 2;
+        const auto mask = cnt - 1;
+
+        List<u32> slots;
+        slots.appends(cnt, 0u);
+        for (u32 id = 0; id < count(); ++id) {
+            auto pos = entries_[id].hash & mask;
+            while (slots[pos] != 0) {
+                pos = (pos + 1) & mask;
+            }
+            slots[pos] = id + 1;
+        }
+        slots_ = move(slots);
+    }
+
+    /* copy the chars (null terminated) to the chunks */
+    const char* store(StrView str) {
+        const auto len = str.count() + 1;
+
+        // long string: own block
+        if (len > $chunk / 16) {
+            auto ptr = mnew<char>(len);
+            mcpy(ptr, str.data(), str.count());
+            ptr[str.count()] = '\0';
+            return ptr;
+        }
+
+        if (len > space_) {
+            chars_ = mnew<char>($chunk);
+            space_ = $chunk;
+        }
+        auto ptr = chars_;
+        mcpy(ptr, str.data(), str.count());
+        ptr[str.count()] = '\0';
+        chars_ += len;
+        space_ -= u32(len);
+        return ptr;
+    }
+};
+
+NMS_API Symbol::Symbol(StrView str)
+    : id_(SymbolTable::instance().intern(str))
+{}
+
+NMS_API bool Symbol::find(StrView str, Symbol& sym) {
+    return SymbolTable::instance().find(str, sym.id_);
+}
+
+NMS_API u32 Symbol::count() {
+    return SymbolTable::instance().count();
+}
+
+NMS_API StrView Symbol::str() const {
+    return SymbolTable::instance().str(id_);
+}
+
+#pragma region unittest
+
+nms_test(symbol) {
+    const Symbol a("nms.symbol.a");
+    const Symbol b(StrView("nms.symbol.b"));
+    const Symbol c(String("nms.symbol.a"));
+
+    test::assert_eq(a == c, true);
+    test::assert_eq(a != b, true);
+    test::assert_eq(a.str(), StrView("nms.symbol.a"));
+    test::assert_eq(Symbol().str(), StrView(""));
+    test::assert_eq(Symbol("").id(), 0u);
+
+    Symbol d;
+    test::assert_eq(Symbol::find("nms.symbol.b", d), true);
+    test::assert_eq(d == b, true);
+    test::assert_eq(Symbol::find("nms.symbol.none", d), false);
+
+    // format
+    test::assert_eq(StrView(format("{}", a)), StrView("nms.symbol.a"));
+}
+
+nms_test(symbol_concurrent) {
+    static const u32 $threads = 4;
+    static const u32 $count   = 10000;
+
+    // the same strings from many threads: the same ids
+    u32 ids[$threads][$count];
+    {
+        List<thread::Thread, $threads> threads;
+        for (u32 t = 0; t < $threads; ++t) {
+            threads.append([&ids, t] {
+                for (u32 i = 0; i < $count; ++i) {
+                    const auto k = (i + t * 997) % $count;
+                    ids[t][k] = Symbol(format("nms.symbol.{}", k)).id();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    auto errs = 0u;
+    for (u32 t = 1; t < $threads; ++t) {
+        for (u32 i = 0; i < $count; ++i) {
+            errs += ids[t][i] == ids[0][i] ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+    test::assert_eq(Symbol(format("nms.symbol.{}", 1234)).id(), ids[0][1234]);
+
+    // compare: id vs chars
+    const Symbol x("nms.thread.ITask.example.name");
+    const Symbol y("nms.thread.ITask.example.name");
+    const String s = x.str();
+    const String r = y.str();
+
+    auto same = 0u;
+    const auto t0 = clock();
+    for (u32 i = 0; i < 1000000; ++i) {
+        same += x == y ? 1 : 0;
+    }
+    const auto t1 = clock();
+    for (u32 i = 0; i < 1000000; ++i) {
+        same += StrView(s) == StrView(r) ? 1 : 0;
+    }
+    const auto t2 = clock();
+
+    test::assert_eq(same, 2000000u);
+    io::log::info("nms.Symbol: {} symbols, 1M compares: symbol {:.3f} ms, string {:.3f} ms", Symbol::count(), (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+#pragma endregion
+
+}
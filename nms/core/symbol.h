@@ -0,0 +1,72 @@
+#pragma once
+
+#include <nms/core/string.h>
+#include <nms/core/format.h>
+
+namespace nms
+{
+
+/*!
+ * interned string.
+ * equal strings get the same id, so compare and hash are O(1).
+ * the chars are kept in a global table (thread safe), and never freed.
+ */
+class Symbol
+{
+public:
+    /* the empty string */
+    constexpr Symbol() noexcept
+        : id_(0)
+    {}
+
+    /* intern the string */
+    NMS_API explicit Symbol(StrView str);
+
+    template<u32 N>
+    explicit Symbol(const char(&s)[N])
+        : Symbol(StrView{ s })
+    {}
+
+    /* find an interned string, returns false if not found */
+    NMS_API static bool find(StrView str, Symbol& sym);
+
+    /* count of interned strings */
+    NMS_API static u32 count();
+
+    u32 id() const noexcept {
+        return id_;
+    }
+
+    u32 hash() const noexcept {
+        return id_;
+    }
+
+    /* the chars, null terminated */
+    NMS_API StrView str() const;
+
+    operator StrView() const {
+        return str();
+    }
+
+    bool operator==(Symbol rhs) const noexcept {
+        return id_ == rhs.id_;
+    }
+
+    bool operator!=(Symbol rhs) const noexcept {
+        return id_ != rhs.id_;
+    }
+
+    /* order by id, not by chars */
+    bool operator<(Symbol rhs) const noexcept {
+        return id_ < rhs.id_;
+    }
+
+private:
+    u32 id_;
+};
+
+inline void formatImpl(String& buf, const StrView& fmt, Symbol val) {
+    formatImpl(buf, fmt, val.str());
+}
+
+}
@@ -11,6 +11,10 @@ template<class T>               constexpr bool $is_pod              = __is_pod(T
 template<class T>               constexpr bool $is_union            = __is_union(T);
 template<class T>               constexpr bool $is_empty            = __is_empty(T);
 template<class B, class    T>   constexpr bool $is_base_of          = __is_base_of(B, T);
+template<class T>               constexpr bool $is_trivially_copyable = __is_trivially_copyable(T);
+
+/* relocatable: an object can be moved by a raw memory copy (eg: realloc). specialize for such types */
+template<class T>               constexpr bool $is_relocatable      = __is_trivially_copyable(T);
 
 #ifdef NMS_CC_GNUC
 template<class T, class ...X>
@@ -39,15 +39,7 @@ private:
 #if defined(NMS_CC_MSVC)
     static constexpr auto funcsig_head_size_ = sizeof("struct nms::View<char const ,0> __cdecl nms::Type::_get_name<") - 1;
     static constexpr auto funcsig_tail_size_ = sizeof(">(void)") - 1;
-#elif defined(NMS_CC_CLANG)
-    static constexpr auto funcsig_head_size_ = sizeof("static Tname nms::Type::_get_name() [T = ") - 1;
-    static constexpr auto funcsig_tail_size_ = sizeof("]") - 1;
-#elif defined(NMS_CC_GNUC)
-    static constexpr auto funcsig_head_size_ = sizeof("static nms::View<const char> nms::Type::_get_name() [with T = ") - 1;
-    static constexpr auto funcsig_tail_size_ = sizeof("]") - 1;
-#else
-#   error("unknow c++ compiler")
-#endif
+
     template<class T>
     static Tname _get_name() {
         static const char* full_name    = __PRETTY_FUNCTION__;
@@ -56,6 +48,40 @@ private:
         static const Tname type_name    = { type_head, type_size };
         return type_name;
     }
+#elif defined(NMS_CC_CLANG) || defined(NMS_CC_GNUC)
+    /* "... [with T = float; Tname = ...]": the text after "T = ", till ';' or ']' */
+    static Tname _parse_name(const char* full_name) {
+        auto head = full_name;
+        while (*head != '\0' && !(head[0] == 'T' && head[1] == ' ' && head[2] == '=' && head[3] == ' ')) {
+            ++head;
+        }
+        head += *head == '\0' ? 0 : 4;
+
+        auto tail  = head;
+        auto depth = 0;
+        for (; *tail != '\0'; ++tail) {
+            const auto c = *tail;
+            if (c == '<' || c == '(' || c == '[') {
+                ++depth;
+            }
+            else if (c == '>' || c == ')' || (c == ']' && depth > 0)) {
+                --depth;
+            }
+            else if (depth == 0 && (c == ';' || c == ']')) {
+                break;
+            }
+        }
+        return { head, u32(tail - head) };
+    }
+
+    template<class T>
+    static Tname _get_name() {
+        static const Tname type_name = _parse_name(__PRETTY_FUNCTION__);
+        return type_name;
+    }
+#else
+#   error("unknow c++ compiler")
+#endif
 };
 
 template<class T>
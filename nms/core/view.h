@@ -10,6 +10,9 @@ namespace nms
 template<class T, u32 N = 0>
 struct View;
 
+template<class T, u32 N>
+struct ViewCursor;
+
 using StrView = View<const char>;
 
 template<class T, u32 N>
@@ -19,7 +22,7 @@ struct View
     constexpr static const auto $rank = N;
 
     using Tdata     = T;
-    using Tsize     = u32;
+    using Tsize     = usize;
     using Trank     = u32;
     using Tdims     = Vec<Tsize,$rank>;
     using Tinfo     = u8x4;
@@ -109,6 +112,35 @@ struct View
         return stride_ == mkStride(size_.data_);
     }
 
+    /*!
+     * test if data and every row (dim 0) start at `align` bytes
+     * `align` should be a power of 2
+     */
+    bool isAligned(u64 align) const noexcept {
+        if ((reinterpret_cast<decltype(sizeof(0))>(data_) & (align - 1)) != 0) {
+            return false;
+        }
+        for (Trank i = 1; i < $rank; ++i) {
+            if (size_[i] > 1 && (u64(stride_[i]) * sizeof(Tdata)) % align != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * count of leading dims, which can be walked as one linear row
+     * (stride[i] == stride[i-1] * size[i-1])
+     * @see ViewCursor
+     */
+    Trank linearRank() const noexcept {
+        Trank rank = 1;
+        while (rank < $rank && stride_[rank] == stride_[rank - 1] * size_[rank - 1]) {
+            ++rank;
+        }
+        return rank;
+    }
+
     /*!
      * test if empty (count()==0)
      * @see count
@@ -211,15 +243,25 @@ View permute(const u32(&order)[$rank]) const {
 }
 
 template<u32 M>
-View<Tdata,M> reshape(const u32(&new_size)[M]) const {
+View<Tdata,M> reshape(const Tsize(&new_size)[M]) const {
     return { data_, new_size};
 }
 
 template<u32 M>
-View<Tdata,M> reshape(const u32(&new_size)[M], const u32(&new_stride)[M]) const {
+View<Tdata,M> reshape(const Tsize(&new_size)[M], const Tsize(&new_stride)[M]) const {
     return { data_, new_size, new_stride};
 }
 
+/*! walk the view row by row */
+ViewCursor<Tdata, $rank> cursor() {
+    return { *this, linearRank() };
+}
+
+/*! walk the view row by row */
+ViewCursor<const Tdata, $rank> cursor() const {
+    return { *this, linearRank() };
+}
+
 #pragma endregion
 
 #pragma region save/load
@@ -249,9 +291,19 @@ protected:
         return idx;
     }
 
+    template<u32 Idim>
+    __forceinline constexpr Tsize index_of(u64 idx) const noexcept {
+        return Tsize(idx);
+    }
+
     template<u32 Idim>
     __forceinline constexpr Tsize index_of(i32 idx) const noexcept {
-        return idx >= 0 ? idx : i32(size_[0]) + idx;
+        return idx >= 0 ? Tsize(idx) : size_[Idim] - Tsize(-idx);
+    }
+
+    template<u32 Idim>
+    __forceinline constexpr Tsize index_of(i64 idx) const noexcept {
+        return idx >= 0 ? Tsize(idx) : size_[Idim] - Tsize(-idx);
     }
 
 #pragma endregion
@@ -335,9 +387,9 @@ struct View<T, 0>
     constexpr static const u32 $rank = 1;
 
     using Tdata = T;
-    using Tsize = u32;
+    using Tsize = usize;
     using Trank = u32;
-    using Tdims = Vec<u32, $rank>;
+    using Tdims = Vec<Tsize, $rank>;
     using Tinfo = u8x4;
 
     template<class U, u32 M>
@@ -402,6 +454,14 @@ struct View<T, 0>
         return count() == 0;
     }
 
+    /*!
+     * test if data starts at `align` bytes
+     * `align` should be a power of 2
+     */
+    bool isAligned(u64 align) const noexcept {
+        return (reinterpret_cast<decltype(sizeof(0))>(data_) & (align - 1)) == 0;
+    }
+
 #pragma endregion
 
 #pragma region access
@@ -462,30 +522,30 @@ struct View<T, 0>
 
 #pragma region slice
     /*! slice */
-    template<class Tidx>
-    View<Tdata> slice(Tidx first, Tidx last) noexcept {
+    template<class Tfirst, class Tlast>
+    View<Tdata> slice(Tfirst first, Tlast last) noexcept {
         const auto data = data_ + offset_of(first);
-        const auto size = offset_of(last) - offset_of(first) + 1;
+        const auto size = Tsize(offset_of(last) - offset_of(first) + 1);
         return { data, size };
     }
 
     /*! slice */
-    template<class Tidx>
-    View<const Tdata> slice(Tidx first, Tidx last) const noexcept {
+    template<class Tfirst, class Tlast>
+    View<const Tdata> slice(Tfirst first, Tlast last) const noexcept {
         const auto data = data_ + offset_of(first);
-        const auto size = offset_of(last) - offset_of(first) + 1;
+        const auto size = Tsize(offset_of(last) - offset_of(first) + 1);
         return { data, size };
     }
 
     /*! slice */
-    template<class Tidx>
-    View<Tdata> operator()(Tidx first, Tidx last) noexcept {
+    template<class Tfirst, class Tlast>
+    View<Tdata> operator()(Tfirst first, Tlast last) noexcept {
         return slice(first, last);
     }
 
     /*! slice */
-    template<class Tidx>
-    View<const Tdata> operator()(Tidx first, Tidx last) const noexcept {
+    template<class Tfirst, class Tlast>
+    View<const Tdata> operator()(Tfirst first, Tlast last) const noexcept {
         return slice(first, last);
     }
 #pragma endregion
@@ -543,7 +603,7 @@ protected:
     Tsize   capacity_   = 0;
 
 #pragma region offset_of
-    __forceinline constexpr u32 offset_of(u32 idx) const noexcept {
+    __forceinline constexpr Tsize offset_of(u32 idx) const noexcept {
         return idx;
     }
 
@@ -551,23 +611,105 @@ protected:
         return idx;
     }
 
-    __forceinline constexpr u32  offset_of(i32 idx) const noexcept {
-        return idx >= 0 ? idx : u32(size_) - u32(-idx);
+    __forceinline constexpr Tsize offset_of(i32 idx) const noexcept {
+        return idx >= 0 ? Tsize(idx) : size_ - Tsize(-idx);
     }
 
     __forceinline constexpr u64 offset_of(i64 idx) const noexcept {
-        return idx >= 0 ? idx : u64(size_) - u64(-idx);
+        return idx >= 0 ? u64(idx) : u64(size_) - u64(-idx);
     }
 
 #pragma endregion
 
 };
 
+/*!
+ * n-d cursor of View, walks the view row by row.
+ * a row is dim 0, merged with the next `inner - 1` dims, which should be linear (@see View::linearRank).
+ * the row pointer is updated incrementally with carry, no multiply per element or per row.
+ */
+template<class T, u32 N>
+struct ViewCursor
+{
+    using Tdata = T;
+    using Tsize = usize;
+    using Trank = u32;
+
+    ViewCursor(const View<T, N>& view, Trank inner)
+        : data_(const_cast<T*>(view.data())), count_(1), step_(view.stride(0)), inner_(inner) {
+        for (Trank i = 0; i < N; ++i) {
+            idx_[i]     = 0;
+            size_[i]    = view.size(i);
+            stride_[i]  = view.stride(i);
+            back_[i]    = stride_[i] * size_[i];
+            if (size_[i] == 0) {
+                data_ = nullptr;
+            }
+        }
+        for (Trank i = 0; i < inner_; ++i) {
+            count_ *= size_[i];
+        }
+    }
+
+    /*! test if all rows are walked */
+    bool isEnd() const noexcept {
+        return data_ == nullptr;
+    }
+
+    /*! first element of current row */
+    T* data() const noexcept {
+        return data_;
+    }
+
+    /*! count of elements in a row */
+    Tsize count() const noexcept {
+        return count_;
+    }
+
+    /*! step between the elements in a row */
+    Tsize step() const noexcept {
+        return step_;
+    }
+
+    /*! index of current row, dims in the row are 0 */
+    const Tsize* index() const noexcept {
+        return idx_;
+    }
+
+    /*! current row as a contiguous span, only if step() == 1 */
+    View<T> span() const noexcept {
+        return { data_, count_ };
+    }
+
+    /*! move to next row */
+    void next() noexcept {
+        for (auto i = inner_; i < N; ++i) {
+            data_ += stride_[i];
+            if (++idx_[i] < size_[i]) {
+                return;
+            }
+            data_  -= back_[i];
+            idx_[i] = 0;
+        }
+        data_ = nullptr;
+    }
+
+protected:
+    T*      data_;
+    Tsize   count_;
+    Tsize   step_;
+    Trank   inner_;
+    Tsize   idx_[N];
+    Tsize   size_[N];
+    Tsize   stride_[N];
+    Tsize   back_[N];       // stride * size
+};
+
 template<class T>
 struct Scalar
 {
     using Trank = u32;
-    using Tsize = u32;
+    using Tsize = usize;
     using Tdata = T;
     using Tview = Scalar;
 
@@ -593,12 +735,12 @@ protected:
 
 #pragma region make
 template<class T, u32 N>
-View<T, N> mkView(T* ptr, const u32(&size)[N], const u32(&stride)[N]) {
+View<T, N> mkView(T* ptr, const usize(&size)[N], const usize(&stride)[N]) {
     return { ptr, size, stride };
 }
 
 template<class T, u32 N>
-View<T, N> mkView(T* ptr, const u32(&size)[N]) {
+View<T, N> mkView(T* ptr, const usize(&size)[N]) {
     return { ptr, size };
 }
 
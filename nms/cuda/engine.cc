@@ -73,7 +73,7 @@ NMS_API Program::Program(StrView src)
     , ptx_{} 
 {
     const auto init_size = 1024u * 1024u;
-    const auto buff_size = max(init_size, src.count());
+    const auto buff_size = max(usize(init_size), src.count());
     src_.reserve(buff_size);
     src_ += src;
 }
@@ -87,7 +87,11 @@ NMS_API void Program::addSrc(StrView src) {
 }
 
 NMS_API bool Program::compile() {
-    static const char*  argv[] = { "--std=c++11", "-default-device", "-restrict", "--use_fast_math", "-arch=compute_30"};
+    static const char*  argv[] = { "--std=c++11", "-default-device", "-restrict", "--use_fast_math", "-arch=compute_30",
+#ifdef NMS_SIZE64
+        "-DNMS_SIZE64",
+#endif
+    };
     static const int    argc = sizeof(argv) / sizeof(argv[0]);
 
     // create program
@@ -147,17 +147,17 @@ struct Kfunc< void(Targ...), func >
 
     protected:
         Module::fun_t   kid_;
-        Vec<u32, N>     size_;
+        Vec<usize, N>   size_;
 
     private:
         friend struct Kfunc;
-        Runner(Module::fun_t kid, const u32(&dims)[N]) 
+        Runner(Module::fun_t kid, const usize(&dims)[N]) 
             : kid_(kid), size_(dims)
         {}
     };
 
     template<u32 N>
-    Runner<N> operator[](const u32(&dims)[N]) {
+    Runner<N> operator[](const usize(&dims)[N]) {
         return { kid_, dims };
     }
 
@@ -166,7 +166,7 @@ protected:
 };
 
 template<class Tfunc, Tfunc* func, u32 N, class ...Targ>
-void invoke(StrView name, const u32 (&dims)[N], Targ&& ...args) {
+void invoke(StrView name, const usize (&dims)[N], Targ&& ...args) {
     Kfunc<Tfunc, func> kfunc(name);
     kfunc[dims](args...);
 }
@@ -37,6 +37,13 @@ using   i64 = long;         using   u64 = unsigned long;
 using f32 = float;
 using f64 = double;
 
+/* same as the host side */
+#ifdef NMS_SIZE64
+using usize = u64;
+#else
+using usize = u32;
+#endif
+
 #ifdef __CUDA_CC__
 using u16x2 = ushort2;
 using u16x3 = ushort3;
@@ -72,12 +79,12 @@ struct Version {};
 template<class T, u32 N>
 struct View
 {
-    T*  data_;
-    u32 size_[N];
-    u32 stride_[N];
+    T*      data_;
+    usize   size_[N];
+    usize   stride_[N];
 
     static constexpr u32 rank()     { return N;         }
-    u32 size(u32 i) const           { return size_[i];  }
+    usize size(u32 i) const         { return size_[i];  }
 
     template<class X>                   T  operator()(X x)           const { return data_[x*stride_[0]];                                 }
     template<class X, class Y>          T  operator()(X x, Y y)      const { return data_[x*stride_[0] + y*stride_[1]];                  }
@@ -99,7 +106,7 @@ struct Scalar
     T   t;
 
     static constexpr u32 rank()             { return 0; }
-    constexpr        u32 size(u32 i) const  { return 0; }
+    constexpr      usize size(u32 i) const  { return 0; }
 
     template<class ...I>
     T operator()(I...) const {
@@ -116,7 +123,7 @@ struct Parallel<Tfunc, A>
     A   a;
 
     static constexpr u32 rank()             { return A::rank(); }
-    constexpr        u32 size(u32 i) const  { return a.size(i); }
+    constexpr      usize size(u32 i) const  { return a.size(i); }
 
     template<class ...I>
     auto operator()(I ...idx) const -> decltype(f(a(idx...))) {
@@ -124,17 +131,61 @@ struct Parallel<Tfunc, A>
     }
 };
 
+/* size of 2 broadcast operands: 0 is any size, 1 is repeated (same as the host side) */
+constexpr usize broadcastSize(usize x, usize y) {
+    return x <= 1 ? (y == 0 ? x : y) : y <= 1 ? x : (x < y ? x : y);
+}
+
+/*!
+ * operand of a binary Parallel, the same layout as the host side Broadcast<X>:
+ * dims of size 1 are repeated (index masked to 0), the indices after X's rank are dropped.
+ */
+template<class X>
+struct Broadcast
+{
+    X       x;
+    usize   mask[X::rank() == 0 ? 1 : X::rank()];
+
+    static constexpr u32 rank()             { return X::rank(); }
+    constexpr      usize size(u32 i) const  { return X::rank() == 0 || i < X::rank() ? x.size(i) : 1; }
+
+    template<class ...I>
+    auto at(Version<0>, I ...idx) const -> decltype(x(idx...)) {
+        return x(idx...);
+    }
+
+    template<class I, class ...J>
+    auto at(Version<1>, I i, J...) const -> decltype(x(i)) {
+        return x(i & mask[0]);
+    }
+
+    template<class I, class J, class ...K>
+    auto at(Version<2>, I i, J j, K...) const -> decltype(x(i, j)) {
+        return x(i & mask[0], j & mask[1]);
+    }
+
+    template<class I, class J, class K>
+    auto at(Version<3>, I i, J j, K k) const -> decltype(x(i, j, k)) {
+        return x(i & mask[0], j & mask[1], k & mask[2]);
+    }
+
+    template<class ...I>
+    auto operator()(I ...idx) const -> decltype(this->at(Version<X::rank()>{}, idx...)) {
+        return at(Version<X::rank()>{}, idx...);
+    }
+};
+
 template<class Tfunc, class A, class B>
 struct Parallel<Tfunc, A, B>
 {
-    A   a;
-    B   b;
+    Broadcast<A>    a;
+    Broadcast<B>    b;
 
     static constexpr u32 rank()             { return max(A::rank(), B::rank()); }
-    constexpr        u32 size(u32 i) const  { return max(a.size(i), b.size(i)); }
+    constexpr      usize size(u32 i) const  { return broadcastSize(a.size(i), b.size(i)); }
 
     template<class ...I>
-    auto operator()(I ...idx) const noexcept->decltype(f(a(idx...), b(idx...))) {
+    auto operator()(I ...idx) const noexcept->decltype(Tfunc::run(a(idx...), b(idx...))) {
         return Tfunc::run(a(idx...), b(idx...));
     }
 
@@ -149,13 +200,13 @@ struct Reduce<Tfunc, T>
     T   t;
 
     static constexpr u32 rank()             { return T::rank() - 1; }
-    constexpr        u32 size(u32 i) const  { return t.size(i + 1); }
+    constexpr      usize size(u32 i) const  { return t.size(i + 1); }
 
     template<class ...I>
     auto operator()(I ...idx) const noexcept -> decltype(t(0, idx...)) {
         const auto  n = t.size(0);
         auto        ret = t(0, idx...);
-        for (u32 i = 1; i < n; ++i) {
+        for (usize i = 1; i < n; ++i) {
             ret = Tfunc::run(ret, t(i, idx...));
         }
 
@@ -169,7 +220,7 @@ struct Linespace
     T k[N];
 
     static constexpr u32 rank()         { return N; }
-    static constexpr u32 size(u32 i)    { return 0; }
+    static constexpr usize size(u32 i)  { return 0; }
 
     template<class I> T operator()(I x)           const noexcept { return T(x)*k[0]; }
     template<class I> T operator()(I x, I y)      const noexcept { return T(x)*k[0] + T(y)*k[1]; }
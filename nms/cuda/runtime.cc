@@ -430,17 +430,18 @@ NMS_API Module::fun_t Module::get_kernel(StrView name) const {
 }
 
 
-NMS_API void Module::run_kernel(fun_t kernel, u32 rank, const u32 dims[], const void* kernel_args[], Stream& stream) const {
+NMS_API void Module::run_kernel(fun_t kernel, u32 rank, const usize dims[], const void* kernel_args[], Stream& stream) const {
     u32 block_dim[3] = {
-        rank == 1 ? min(256u, dims[0]) : rank == 2 ? 16u : rank == 3 ? 8u : 8u,
-        rank == 1 ? min(001u, dims[0]) : rank == 2 ? 16u : rank == 3 ? 8u : 8u,
-        rank == 1 ? min(001u, dims[0]) : rank == 2 ? 01u : rank == 3 ? 8u : 8u,
+        rank == 1 ? u32(min(usize(256), dims[0])) : rank == 2 ? 16u : rank == 3 ? 8u : 8u,
+        rank == 1 ? u32(min(usize(001), dims[0])) : rank == 2 ? 16u : rank == 3 ? 8u : 8u,
+        rank == 1 ? u32(min(usize(001), dims[0])) : rank == 2 ? 01u : rank == 3 ? 8u : 8u,
     };
 
+    // grid size is 32-bit, even with NMS_SIZE64
     u32 grid_dim[3] = {
-        rank > 0 ? (dims[0] + block_dim[0] - 1) / block_dim[0] : 1,
-        rank > 1 ? (dims[1] + block_dim[1] - 1) / block_dim[1] : 1,
-        rank > 2 ? (dims[2] + block_dim[2] - 1) / block_dim[2] : 1
+        rank > 0 ? u32((dims[0] + block_dim[0] - 1) / block_dim[0]) : 1,
+        rank > 1 ? u32((dims[1] + block_dim[1] - 1) / block_dim[1]) : 1,
+        rank > 2 ? u32((dims[2] + block_dim[2] - 1) / block_dim[2]) : 1
     };
 
     const auto shared_mem_bytes   = 0;
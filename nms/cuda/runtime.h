@@ -100,7 +100,7 @@ public:
 
     /* invoke kernel */
     template<class ...Targ>
-    void invoke(fun_t kernel, u32 rank, const u32 dims[], const Targ& ...args) {
+    void invoke(fun_t kernel, u32 rank, const usize dims[], const Targ& ...args) {
         const void* argv[] = { &args... };
         run_kernel(kernel, rank, dims, argv);
     }
@@ -109,7 +109,7 @@ public:
     NMS_API void    set_symbol(sym_t   symbol, const void* value, u32 size) const;
 
     NMS_API fun_t   get_kernel(StrView name) const;
-    NMS_API void    run_kernel(fun_t   func, u32 rank, const u32 dims[], const void* argv[], Stream& stream=Stream::global()) const;
+    NMS_API void    run_kernel(fun_t   func, u32 rank, const usize dims[], const void* argv[], Stream& stream=Stream::global()) const;
 
 protected:
     CUmod_st* module_ = nullptr;
@@ -4,10 +4,18 @@
 #include <nms/math/array.h>
 
 #include <nms/math/view.h>
+#include <nms/math/complex.h>
+#include <nms/math/half.h>
+#include <nms/math/convert.h>
 #include <nms/math/linspace.h>
 #include <nms/math/eye.h>
 #include <nms/math/norm.h>
 #include <nms/math/blas.h>
+#include <nms/math/stencil.h>
+#include <nms/math/sampler.h>
+#include <nms/math/sort.h>
+#include <nms/math/random.h>
+#include <nms/math/jit.h>
 
 namespace nms
 {
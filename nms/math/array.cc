@@ -29,6 +29,323 @@ nms_test(array_basic) {
     io::console::writeln("e = {:-6.3}", e);
 }
 
+nms_test(array_move) {
+    // each buffer is released once: by move-assign, resize, or the destructor
+    auto dels = 0u;
+    f32 buf[3][4];
+    {
+        Array<f32, 1> a(buf[0], { 4u }, [&] { ++dels; });
+        Array<f32, 1> b(buf[1], { 4u }, [&] { ++dels; });
+        a = move(b);
+        test::assert_eq(dels, 1u);
+        test::assert_eq(a.data(), buf[1]);
+        test::assert_eq(b.data(), static_cast<f32*>(nullptr));
+
+        Array<f32, 1> c(buf[2], { 4u }, [&] { ++dels; });
+        c.resize({ 8u });
+        test::assert_eq(dels, 2u);
+
+        a = move(a);
+        test::assert_eq(dels, 2u);
+    }
+    test::assert_eq(dels, 3u);
+}
+
+nms_test(array_size) {
+    // size and offsets are usize: u64 with NMS_SIZE64
+    const View<const f32, 3> v(nullptr, { 4096u, 4096u, 512u });
+    test::assert_eq(sizeof(v.count()), sizeof(usize));
+    if (sizeof(usize) == sizeof(u64)) {
+        test::assert_eq(u64(v.count()),     u64(4096) * 4096 * 512);
+        test::assert_eq(u64(v.stride(2)),   u64(4096) * 4096);
+    }
+
+    // negative index counts from the end of its own dim
+    Array<f32, 2> a({ 4u, 8u });
+    test::assert_eq(&a(-1, -1), &a(3, 7));
+}
+
+nms_test(array_align) {
+    // default: the buffer is aligned to a cache line
+    Array<f32, 2> a({ 30u, 7u });
+    test::assert_eq(maligned(a.data(), $align_line), true);
+    test::assert_eq(a.isAligned($align_line), false);
+
+    // padded: each row is aligned
+    Array<f32, 2> b({ 30u, 7u }, $align_line);
+    test::assert_eq(b.stride(1), 32u);
+    test::assert_eq(b.isAligned($align_line), true);
+    test::assert_eq(b.isNormal(), false);
+
+    b <<= lins(1.0f, 100.0f);
+    a <<= b;
+    test::assert_eq(a(29, 6), b(29, 6));
+    test::assert_eq(a(29, 6), 29.0f + 600.0f);
+
+    Array<f64, 3> c({ 5u, 3u, 2u }, $align_page);
+    test::assert_eq(c.isAligned($align_page), true);
+    test::assert_eq(c.stride(2), 512u * 3u);
+}
+
+nms_test(array_cursor) {
+    Array<u32, 3> a({ 4u, 5u, 6u });
+    for (u32 k = 0; k < 6; ++k) {
+        for (u32 j = 0; j < 5; ++j) {
+            for (u32 i = 0; i < 4; ++i) {
+                a(i, j, k) = i + j * 10 + k * 100;
+            }
+        }
+    }
+
+    // normal: one row
+    auto ca = a.cursor();
+    test::assert_eq(ca.count(), 120u);
+    test::assert_eq(ca.span()[119], 3u + 40u + 500u);
+    ca.next();
+    test::assert_eq(ca.isEnd(), true);
+
+    // sliced: rows of dim 0, same elements as at()
+    auto s = a.slice({ 1u, 2u }, { 0u, 4u }, { 2u, 5u });
+    auto errs = 0u;
+    auto rows = 0u;
+    for (auto c = s.cursor(); !c.isEnd(); c.next(), ++rows) {
+        const auto idx = c.index();
+        for (u32 i = 0; i < c.count(); ++i) {
+            errs += c.data()[i * c.step()] == s(i, idx[1], idx[2]) ? 0 : 1;
+        }
+    }
+    test::assert_eq(rows, 5u * 4u);
+    test::assert_eq(errs, 0u);
+
+    // permuted: copy by cursor equals at()
+    auto p = a.permute({ 2u, 0u, 1u });
+    Array<u32, 3> b({ 6u, 4u, 5u });
+    b <<= p;
+    for (u32 k = 0; k < 5; ++k) {
+        for (u32 j = 0; j < 4; ++j) {
+            for (u32 i = 0; i < 6; ++i) {
+                errs += b(i, j, k) == a(j, k, i) ? 0 : 1;
+            }
+        }
+    }
+    test::assert_eq(errs, 0u);
+}
+
+nms_test(array_cursor_bench) {
+    static const u32 $size = 1024;
+
+    Array<f32, 3> a({ $size, $size, 4u });
+    Array<f32, 3> b({ $size, $size, 4u });
+    a <<= 1.0f;
+
+    // at(): a multiply per dim for every element
+    auto sum = 0.0f;
+    const auto t0 = clock();
+    for (u32 k = 0; k < 4; ++k) {
+        for (u32 j = 0; j < $size; ++j) {
+            for (u32 i = 0; i < $size; ++i) {
+                b(i, j, k) = a(i, j, k);
+            }
+        }
+    }
+    const auto t1 = clock();
+    b <<= a;
+    const auto t2 = clock();
+    for (auto c = b.cursor(); !c.isEnd(); c.next()) {
+        for (auto v : c.span()) {
+            sum += v;
+        }
+    }
+
+    test::assert_eq(sum, f32($size * $size * 4));
+    io::log::info("nms.math.Array: copy {}x{}x4: at() {:.3f} ms, cursor {:.3f} ms", $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+nms_test(array_transpose) {
+    // partial tiles
+    Array<f32, 2> a({ 37u, 45u });
+    a <<= lins(1.0f, 1000.0f);
+
+    Array<f32, 2> b({ 45u, 37u });
+    b <<= a.permute({ 1u, 0u });
+    auto errs = 0u;
+    for (u32 j = 0; j < 45; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            errs += b(j, i) == a(i, j) ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // non-copy function
+    Array<f64, 3> c({ 20u, 3u, 33u });
+    Array<f64, 3> d({ 33u, 3u, 20u });
+    c <<= lins(1.0, 100.0, 1000.0);
+    d <<= 1.0;
+    d += c.permute({ 2u, 1u, 0u });
+    for (u32 k = 0; k < 20; ++k) {
+        for (u32 j = 0; j < 3; ++j) {
+            for (u32 i = 0; i < 33; ++i) {
+                errs += d(i, j, k) == c(k, j, i) + 1.0 ? 0 : 1;
+            }
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // empty: the size 0 dim is a carried dim
+    Array<f32, 3> e({ 16u, 16u, 0u });
+    Array<f32, 3> f({ 16u, 16u, 0u });
+    f <<= e.permute({ 1u, 0u, 2u });
+    test::assert_eq(f.count(), usize(0));
+
+    // bench
+    static const u32 $size = 2048;
+    Array<f32, 2> x({ $size, $size });
+    Array<f32, 2> y({ $size, $size });
+    x <<= lins(1.0f, 2.0f);
+    const auto xt = x.permute({ 1u, 0u });
+
+    const auto t0 = clock();
+    for (u32 j = 0; j < $size; ++j) {
+        for (u32 i = 0; i < $size; ++i) {
+            y(i, j) = xt(i, j);
+        }
+    }
+    const auto t1 = clock();
+    y <<= xt;
+    const auto t2 = clock();
+
+    test::assert_eq(y(3, 5), x(5, 3));
+    io::log::info("nms.math.Array: transpose {}x{} f32: naive {:.3f} ms, tiled {:.3f} ms", $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+nms_test(array_broadcast) {
+    Array<f32, 2> a({ 5u, 4u });
+    Array<f32, 2> c({ 5u, 4u });
+    Array<f32, 1> row({ 5u });
+    Array<f32, 2> col({ 1u, 4u });
+    a   <<= lins(1.0f, 10.0f);
+    row <<= lins(0.5f);
+    col <<= lins(0.0f, 2.0f);
+
+    // missing dim
+    auto errs = 0u;
+    c <<= a + row;
+    for (u32 j = 0; j < 4; ++j) {
+        for (u32 i = 0; i < 5; ++i) {
+            errs += c(i, j) == a(i, j) + row(i) ? 0 : 1;
+        }
+    }
+
+    // dim of size 1
+    c <<= a * col - row;
+    for (u32 j = 0; j < 4; ++j) {
+        for (u32 i = 0; i < 5; ++i) {
+            errs += c(i, j) == a(i, j) * col(0, j) - row(i) ? 0 : 1;
+        }
+    }
+
+    // view to view: stride 0
+    c <<= row;
+    c += col;
+    for (u32 j = 0; j < 4; ++j) {
+        for (u32 i = 0; i < 5; ++i) {
+            errs += c(i, j) == row(i) + col(0, j) ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // bench: remove the row mean, with a temporary or broadcast
+    static const u32 $size = 1024;
+    Array<f32, 2> x({ $size, $size });
+    Array<f32, 2> y({ $size, $size });
+    Array<f32, 2> t({ $size, $size });
+    Array<f32, 1> m({ $size });
+    x <<= lins(1.0f, 2.0f);
+    m <<= lins(0.5f);
+
+    const auto t0 = clock();
+    for (u32 j = 0; j < $size; ++j) {
+        for (u32 i = 0; i < $size; ++i) {
+            t(i, j) = m(i);
+        }
+    }
+    y <<= x - t;
+    const auto t1 = clock();
+    y <<= x - m;
+    const auto t2 = clock();
+
+    test::assert_eq(y(7, 9), x(7, 9) - m(7));
+    io::log::info("nms.math.Array: x - mean {}x{} f32: temporary {:.3f} ms, broadcast {:.3f} ms", $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+nms_test(array_fuse) {
+    Array<f32, 2> x({ 33u, 17u });
+    Array<f32, 2> y({ 33u, 17u });
+    Array<f32, 2> z({ 33u, 17u });
+    Array<f32, 1> row({ 33u });
+    x   <<= lins(1.0f, 100.0f);
+    z   <<= 1.0f;
+    row <<= lins(0.5f);
+
+    f64 sum  = 0;
+    f64 sum2 = 0;
+    f32 vmax = 0;
+    test::assert_eq(fuse(assign(y, x * 2 - row), accum(z, x), fold(sum, x), fold(sum2, x * x), fold<Max>(vmax, x)), true);
+
+    auto errs = 0u;
+    f64  ssum = 0;
+    f64  ssum2 = 0;
+    for (u32 j = 0; j < 17; ++j) {
+        for (u32 i = 0; i < 33; ++i) {
+            errs  += y(i, j) == x(i, j) * 2 - row(i) ? 0 : 1;
+            errs  += z(i, j) == x(i, j) + 1 ? 0 : 1;
+            ssum  += x(i, j);
+            ssum2 += x(i, j) * x(i, j);
+        }
+    }
+    test::assert_eq(errs, 0u);
+    test::assert_eq(sum,  ssum);
+    test::assert_eq(sum2, ssum2);
+    test::assert_eq(vmax, x(32, 16));
+
+    // size not match
+    Array<f32, 2> w({ 32u, 17u });
+    test::assert_eq(fuse(assign(y, x), assign(w, x)), false);
+
+    // a folded input larger than the domain
+    Array<f32, 1> ones33({ 33u });
+    Array<f32, 1> ones20({ 20u });
+    ones33 <<= 1.0f;
+    ones20 <<= 1.0f;
+    f32 s = 0, t = 0;
+    test::assert_eq(fuse(fold(s, ones33), fold(t, ones20)), false);
+    test::assert_eq(s, 0.0f);
+
+    // bench: 3 passes vs 1 pass
+    static const u32 $size = 1024;
+    Array<f32, 2> a({ $size, $size });
+    Array<f32, 2> b({ $size, $size });
+    Array<f32, 2> c({ $size, $size });
+    a <<= lins(1.0f, 2.0f);
+
+    const auto t0 = clock();
+    b <<= a * 2.0f;
+    c <<= a * a;
+    f32 s0 = 0;
+    for (u32 j = 0; j < $size; ++j) {
+        for (u32 i = 0; i < $size; ++i) {
+            s0 += a(i, j);
+        }
+    }
+    const auto t1 = clock();
+    f32 s1 = 0;
+    fuse(assign(b, a * 2.0f), assign(c, a * a), fold(s1, a));
+    const auto t2 = clock();
+
+    test::assert_eq(s0, s1);
+    io::log::info("nms.math.Array: 2 outputs + sum {}x{} f32: separate {:.3f} ms, fused {:.3f} ms", $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
 nms_test(array_math) {
     // a = zeros(32, 32)
 
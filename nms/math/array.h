@@ -28,14 +28,30 @@ class Array
         , deleter_(fwd<D>(deleter))
     {}
 
+    /* the buffer is aligned to a cache line */
     explicit Array(const Tsize(&dims)[N])
         : base(nullptr, dims)
     {
         const auto n= base::count();
         if (n != 0) {
-            auto dat    = mnew<T>(n);
+            auto dat    = mnew_align<T>(n, $align_line);
             base::data_ = dat;
-            deleter_    = delegate<void()>([=] { mdel(dat); });
+            deleter_    = delegate<void()>([=] { mdel_align(dat); });
+        }
+    }
+
+    /*!
+     * the buffer is aligned to `align` bytes, and each row (dim 0) is padded to a multiple of `align` bytes.
+     * `align` should be a power of 2, e.g. $align_line or $align_page.
+     */
+    Array(const Tsize(&dims)[N], u64 align)
+        : base(nullptr, dims, mkStride(dims, align))
+    {
+        const auto n = base::size_[$rank - 1] * base::stride_[$rank - 1];
+        if (n != 0) {
+            auto dat    = mnew_align<T>(n, align);
+            base::data_ = dat;
+            deleter_    = delegate<void()>([=] { mdel_align(dat); });
         }
     }
 
@@ -61,8 +77,15 @@ class Array
     }
 
     Array& operator=(Array&& rhs) noexcept {
-        base::operator  = (static_cast<base&&>(rhs));
-        deleter_        = move(rhs.deleter_);
+        if (this != &rhs) {
+            // release the old buffer, the deleter is replaced by rhs's
+            if (base::data_ != nullptr && deleter_) {
+                deleter_();
+            }
+            base::operator  = (static_cast<base&&>(rhs));
+            deleter_        = move(rhs.deleter_);
+            rhs.data_       = nullptr;
+        }
         return *this;
     }
 
@@ -72,7 +95,7 @@ class Array
         return tmp;
     }
 
-    Array& resize(const u32(&newlen)[base::$rank]) {
+    Array& resize(const Tsize(&newlen)[base::$rank]) {
         const auto oldlen = base::size();
 
         if (oldlen == Tdims{ newlen }) {
@@ -118,6 +141,18 @@ protected:
 private:
     delegate<void()>    deleter_;
 
+    /* stride of padded rows */
+    static Tdims mkStride(const Tsize(&dims)[N], u64 align) {
+        const auto pad = Tsize(align % sizeof(T) == 0 ? align / sizeof(T) : 1);
+
+        Tdims stride;
+        stride[0] = 1;
+        for (u32 i = 1; i < N; ++i) {
+            stride[i] = i == 1 ? (dims[0] + pad - 1) / pad * pad : stride[i - 1] * dims[i - 1];
+        }
+        return stride;
+    }
+
     template<class File>
     void saveFile(File& file) const {
         const auto info = base::info();
@@ -125,13 +160,17 @@ private:
 
         file.write(&info, 1);
         file.write(&size, 1);
-        file.write(base::data(), base::count());
+
+        // padded rows are written one by one
+        for (auto c = base::cursor(); !c.isEnd(); c.next()) {
+            file.write(c.data(), c.count());
+        }
     }
 
     template<class File>
     static Array loadFile(const File& file) {
         u8x4        info;
-        Vec<u32, N> size;
+        Tdims       size;
 
         file.read(&info, 1);
         file.read(&size, 1);
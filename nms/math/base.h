@@ -104,7 +104,12 @@ struct Or  { template<class T>          __forceinline static auto run(const T& a
 
 struct Pos { template<class T> __forceinline static auto run(T t) noexcept { return +t; } };
 struct Neg { template<class T> __forceinline static auto run(T t) noexcept { return -t; } };
-struct Abs { template<class T> __forceinline static auto run(T t) noexcept { return t<0 ? t : 0 - t; } };
+struct Abs {
+    template<class T> __forceinline static auto run(T t) noexcept {
+        if constexpr($is<$number, T>) { return t < T(0) ? T(0) - t : t; }
+        else                          { return abs(t); }
+    }
+};
 
 struct Add { template<class X, class Y> __forceinline constexpr static auto run(const X& x, const Y& y) noexcept { return x + y; } };
 struct Sub { template<class X, class Y> __forceinline constexpr static auto run(const X& x, const Y& y) noexcept { return x - y; } };
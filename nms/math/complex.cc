@@ -0,0 +1,151 @@
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io/log.h>
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+nms_test(complex) {
+    const cf32 a = { 3.0f, 4.0f };
+    const cf32 b = { 1.0f, -2.0f };
+
+    test::assert_eq(abs(a), 5.0f);
+    test::assert_eq(norm(a), 25.0f);
+
+    const auto c = a * b;
+    test::assert_eq(c.r, 11.0f);
+    test::assert_eq(c.i, -2.0f);
+
+    const auto d = c / b;
+    test::assert_eq(d.r, 3.0f);
+    test::assert_eq(d.i, 4.0f);
+
+    const auto e = a * 2.0f;
+    test::assert_eq(e.i, 8.0f);
+
+    const auto f = 1.0f - a;
+    test::assert_eq(f.i, -4.0f);
+
+    // vabs: magnitude
+    Array<cf32, 1> v({ 3u });
+    Array<f32,  1> m({ 3u });
+    v(0) = a; v(1) = b; v(2) = { 0.0f, -2.0f };
+    m <<= vabs(v);
+    test::assert_eq(m(0), 5.0f);
+    test::assert_eq(m(2), 2.0f);
+
+    Array<f32, 1> r({ 3u });
+    r <<= vabs(lins(-1.0f));
+    test::assert_eq(r(2), 2.0f);
+}
+
+nms_test(complex_kernels) {
+    // odd sizes: the tails of the SSE loops
+    Array<cf32, 2> a({ 37u, 5u });
+    Array<cf32, 2> b({ 37u, 5u });
+    Array<cf32, 2> y({ 37u, 5u });
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            a(i, j) = { f32(i) * 0.5f - 3.0f, f32(j) + 1.0f };
+            b(i, j) = { f32(j) - 2.0f, f32(i) * 0.25f };
+        }
+    }
+
+    auto errs = 0u;
+    auto check = [&](cf32 x, cf32 z) {
+        errs += abs(x - z) <= 1e-5f * (1.0f + abs(z)) ? 0 : 1;
+    };
+
+    cmul(y, a, b);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            check(y(i, j), a(i, j) * b(i, j));
+        }
+    }
+
+    cmulc(y, a, b);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            check(y(i, j), a(i, j) * ~b(i, j));
+        }
+    }
+
+    cadd(y, a, b);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            check(y(i, j), a(i, j) + b(i, j));
+        }
+    }
+
+    // strided
+    auto at = a.permute({ 1u, 0u });
+    Array<cf32, 2> z({ 5u, 37u });
+    cconj(z, at);
+    for (u32 j = 0; j < 37; ++j) {
+        for (u32 i = 0; i < 5; ++i) {
+            check(z(i, j), ~a(j, i));
+        }
+    }
+
+    Array<f32, 2> m({ 37u, 5u });
+    cabs(m, a);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            errs += abs(m(i, j) - abs(a(i, j))) <= 1e-5f * m(i, j) ? 0 : 1;
+        }
+    }
+    cnorm(m, a);
+    test::assert_eq(m(3, 2), norm(a(3, 2)));
+    test::assert_eq(errs, 0u);
+
+    // split layout: split, multiply in place, merge
+    Array<f32, 2> ar({ 37u, 5u }), ai({ 37u, 5u });
+    Array<f32, 2> br({ 37u, 5u }), bi({ 37u, 5u });
+    SplitView<f32, 2> sa = { ar, ai };
+    SplitView<f32, 2> sb = { br, bi };
+    split(sa, a);
+    split(sb, b);
+    test::assert_eq(ar(5, 3), a(5, 3).r);
+    test::assert_eq(ai(5, 3), a(5, 3).i);
+
+    cmul(sa, sa, sb);
+    merge(y, sa);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            check(y(i, j), a(i, j) * b(i, j));
+        }
+    }
+    test::assert_eq(errs, 0u);
+}
+
+nms_test(complex_bench) {
+    static const u32 $size = 1024;
+
+    Array<cf32, 2> a({ $size, $size });
+    Array<cf32, 2> b({ $size, $size });
+    Array<cf32, 2> y({ $size, $size });
+    Array<cf32, 2> z({ $size, $size });
+    for (u32 j = 0; j < $size; ++j) {
+        for (u32 i = 0; i < $size; ++i) {
+            a(i, j) = { f32(i), f32(j) };
+            b(i, j) = { f32(j), -f32(i) };
+        }
+    }
+
+    const auto t0 = clock();
+    y <<= a * b;
+    const auto t1 = clock();
+    cmul(z, a, b);
+    const auto t2 = clock();
+
+    test::assert_eq(y(7, 9).r, z(7, 9).r);
+    test::assert_eq(y(7, 9).i, z(7, 9).i);
+    io::log::info("nms.math.complex: {}x{} cf32 multiply, expression {:.3f} ms, cmul {:.3f} ms",
+        $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+#pragma endregion
+
+}
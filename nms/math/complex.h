@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nms/core/type.h>
+#include <nms/math/view.h>
 
 namespace nms::math
 {
@@ -19,29 +20,299 @@ public:
 using cf32 = complex<f32>;
 using cf64 = complex<f64>;
 
-template<class T> constexpr T abs(complex<T> t) { return t.r*t.r + t.i*t.i; }
+/* squared magnitude: r*r + i*i */
+template<class T> constexpr T norm(complex<T> t) { return t.r*t.r + t.i*t.i; }
 
-template<class T> constexpr complex<T> operator~(complex<T> t) { return { t.r, -t.i }; }
+/* magnitude */
+template<class T> inline T abs(complex<T> t) { return T(sqrt(norm(t))); }
+
+template<class T> constexpr complex<T> conj(complex<T> t)       { return { t.r, -t.i }; }
+template<class T> constexpr complex<T> operator~(complex<T> t)  { return { t.r, -t.i }; }
+template<class T> constexpr complex<T> operator-(complex<T> t)  { return { -t.r, -t.i }; }
 
 template<class T> constexpr complex<T> operator+(complex<T> a, T b) { return { a.r + b, a.i }; }
 template<class T> constexpr complex<T> operator-(complex<T> a, T b) { return { a.r - b, a.i }; }
-template<class T> constexpr complex<T> operator*(complex<T> a, T b) { return { a.r * b, a.i }; }
-template<class T> constexpr complex<T> operator/(complex<T> a, T b) { return { a.r / b, a.i }; }
+template<class T> constexpr complex<T> operator*(complex<T> a, T b) { return { a.r * b, a.i * b }; }
+template<class T> constexpr complex<T> operator/(complex<T> a, T b) { return { a.r / b, a.i / b }; }
 
 template<class T> constexpr complex<T> operator+(T a, complex<T> b) { return { a + b.r, b.i }; }
-template<class T> constexpr complex<T> operator-(T a, complex<T> b) { return { a - b.r, b.i }; }
+template<class T> constexpr complex<T> operator-(T a, complex<T> b) { return { a - b.r, -b.i }; }
 template<class T> constexpr complex<T> operator*(T a, complex<T> b) { return { a * b.r, a * b.i }; }
-template<class T> constexpr complex<T> operator/(T a, complex<T> b) { return { a * b.r/(b.r*b.r+b.i*b.i), a * b.i/(b.r*b.r+b.i*b.i)}; }
+template<class T> constexpr complex<T> operator/(T a, complex<T> b) { return { a * b.r/(b.r*b.r+b.i*b.i), -a * b.i/(b.r*b.r+b.i*b.i)}; }
 
 template<class T> constexpr complex<T> operator+(complex<T> a, complex<T> b) { return { a.r + b.r, a.i + b.i }; }
 template<class T> constexpr complex<T> operator-(complex<T> a, complex<T> b) { return { a.r - b.r, a.i - b.i }; }
 template<class T> constexpr complex<T> operator*(complex<T> a, complex<T> b) { return { a.r * b.r-a.i*b.i, a.r*b.i + a.i*b.r }; }
-template<class T> constexpr complex<T> operator/(complex<T> a, complex<T> b) { return { (a*~b) / abs(b) }; }
+template<class T> constexpr complex<T> operator/(complex<T> a, complex<T> b) { return { (a*~b) / norm(b) }; }
 
 template<class T, class U> complex<T> operator+=(complex<T>& a, U b) { a = a + b;  return a; }
 template<class T, class U> complex<T> operator-=(complex<T>& a, U b) { a = a - b;  return a; }
 template<class T, class U> complex<T> operator*=(complex<T>& a, U b) { a = a * b;  return a; }
 template<class T, class U> complex<T> operator/=(complex<T>& a, U b) { a = a / b;  return a; }
 
+#pragma region kernels
+
+namespace ns_complex
+{
+
+/* y = a * b, or a * ~b */
+template<bool Conj, class T>
+void mulRow(usize n, ViewRow<complex<T>> y, ViewRow<complex<T>> a, ViewRow<complex<T>> b) {
+    for (usize i = 0; i < n; ++i) {
+        y[i] = Conj ? a[i] * ~b[i] : a[i] * b[i];
+    }
+}
+
+/* |a|, or |a|^2 */
+template<bool Sqrt, class T>
+void absRow(usize n, ViewRow<T> y, ViewRow<complex<T>> a) {
+    for (usize i = 0; i < n; ++i) {
+        y[i] = Sqrt ? abs(a[i]) : norm(a[i]);
+    }
+}
+
+/* 6 views of a split multiply: the parts are read before written, item by item */
+template<bool Conj, class S>
+void mulSplit(const S& y, const S& a, const S& b) {
+    using V = decltype(y.re);
+    using T = typename V::Tdata;
+    constexpr static const u32 N = V::$rank;
+
+    const V* views[] = { &y.re, &y.im, &a.re, &a.im, &b.re, &b.im };
+    for (auto v : views) {
+        if (!(v->size() == y.re.size())) {
+            NMS_THROW(EBadSize{});
+        }
+    }
+
+    const auto n = y.re.size(0);
+    for (ViewCursor<T, N> c(y.re, 1); !c.isEnd(); c.next()) {
+        const auto idx = c.index();
+
+        ViewRow<T> r[6];
+        for (u32 k = 0; k < 6; ++k) {
+            auto p = views[k]->data();
+            for (u32 d = 1; d < N; ++d) {
+                p += idx[d] * views[k]->stride(d);
+            }
+            r[k] = { const_cast<T*>(p), views[k]->stride(0) };
+        }
+
+        for (usize i = 0; i < n; ++i) {
+            const auto ar = r[2][i];
+            const auto ai = r[3][i];
+            const auto br = r[4][i];
+            const auto bi = Conj ? -r[5][i] : r[5][i];
+            r[0][i] = ar * br - ai * bi;
+            r[1][i] = ar * bi + ai * br;
+        }
+    }
+}
+
+#ifdef NMS_MATH_SSE
+/* interleaved cf32 rows: 2 items per register */
+template<bool Conj>
+void mulRow(usize n, ViewRow<cf32> y, ViewRow<cf32> a, ViewRow<cf32> b) {
+    usize i = 0;
+    if (y.step == 1 && a.step == 1 && b.step == 1) {
+        const auto py   = reinterpret_cast<f32*>(y.data);
+        const auto pa   = reinterpret_cast<const f32*>(a.data);
+        const auto pb   = reinterpret_cast<const f32*>(b.data);
+        const auto sign = Conj ? _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f) : _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+
+        for (; i + 2 <= n; i += 2) {
+            const auto va = _mm_loadu_ps(pa + 2 * i);                       // ar0 ai0 ar1 ai1
+            const auto vb = _mm_loadu_ps(pb + 2 * i);                       // br0 bi0 br1 bi1
+            const auto br = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 2, 0, 0));  // br0 br0 br1 br1
+            const auto bi = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 3, 1, 1));  // bi0 bi0 bi1 bi1
+            const auto as = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 3, 0, 1));  // ai0 ar0 ai1 ar1
+            const auto vy = _mm_add_ps(_mm_mul_ps(va, br), _mm_mul_ps(_mm_mul_ps(as, bi), sign));
+            _mm_storeu_ps(py + 2 * i, vy);
+        }
+    }
+    for (; i < n; ++i) {
+        y[i] = Conj ? a[i] * ~b[i] : a[i] * b[i];
+    }
+}
+
+template<bool Sqrt>
+void absRow(usize n, ViewRow<f32> y, ViewRow<cf32> a) {
+    usize i = 0;
+    if (y.step == 1 && a.step == 1) {
+        const auto pa = reinterpret_cast<const f32*>(a.data);
+        for (; i + 4 <= n; i += 4) {
+            const auto v0 = _mm_loadu_ps(pa + 2 * i + 0);
+            const auto v1 = _mm_loadu_ps(pa + 2 * i + 4);
+            const auto re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+            const auto im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+            const auto nr = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+            _mm_storeu_ps(y.data + i, Sqrt ? _mm_sqrt_ps(nr) : nr);
+        }
+    }
+    for (; i < n; ++i) {
+        y[i] = Sqrt ? abs(a[i]) : norm(a[i]);
+    }
+}
+#endif
+
+}
+
+/* y = a * b, item-wise. y may be a or b. */
+template<class T, u32 N>
+void cmul(View<complex<T>, N> y, const View<complex<T>, N>& a, const View<complex<T>, N>& b) {
+    rowwise([](usize n, auto ry, auto ra, auto rb) { ns_complex::mulRow<false>(n, ry, ra, rb); }, y, a, b);
+}
+
+/* y = a * ~b, item-wise: cross spectrum (correlation) */
+template<class T, u32 N>
+void cmulc(View<complex<T>, N> y, const View<complex<T>, N>& a, const View<complex<T>, N>& b) {
+    rowwise([](usize n, auto ry, auto ra, auto rb) { ns_complex::mulRow<true>(n, ry, ra, rb); }, y, a, b);
+}
+
+/* y = a + b, item-wise */
+template<class T, u32 N>
+void cadd(View<complex<T>, N> y, const View<complex<T>, N>& a, const View<complex<T>, N>& b) {
+    // complex<T> is 2 x T: add as reals
+    rowwise([](usize n, auto ry, auto ra, auto rb) {
+        if (ry.step == 1 && ra.step == 1 && rb.step == 1) {
+            const auto py = reinterpret_cast<T*>(ry.data);
+            const auto pa = reinterpret_cast<const T*>(ra.data);
+            const auto pb = reinterpret_cast<const T*>(rb.data);
+            for (usize i = 0; i < 2 * n; ++i) {
+                py[i] = pa[i] + pb[i];
+            }
+            return;
+        }
+        for (usize i = 0; i < n; ++i) {
+            ry[i] = ra[i] + rb[i];
+        }
+    }, y, a, b);
+}
+
+/* y = ~a, item-wise */
+template<class T, u32 N>
+void cconj(View<complex<T>, N> y, const View<complex<T>, N>& a) {
+    rowwise([](usize n, auto ry, auto ra) {
+        if (ry.step == 1 && ra.step == 1) {
+            const auto py = reinterpret_cast<T*>(ry.data);
+            const auto pa = reinterpret_cast<const T*>(ra.data);
+            for (usize i = 0; i < 2 * n; i += 2) {
+                py[i + 0] =  pa[i + 0];
+                py[i + 1] = -pa[i + 1];
+            }
+            return;
+        }
+        for (usize i = 0; i < n; ++i) {
+            ry[i] = ~ra[i];
+        }
+    }, y, a);
+}
+
+/* y = |a|, item-wise */
+template<class T, u32 N>
+void cabs(View<T, N> y, const View<complex<T>, N>& a) {
+    rowwise([](usize n, auto ry, auto ra) { ns_complex::absRow<true>(n, ry, ra); }, y, a);
+}
+
+/* y = |a|^2, item-wise: power spectrum */
+template<class T, u32 N>
+void cnorm(View<T, N> y, const View<complex<T>, N>& a) {
+    rowwise([](usize n, auto ry, auto ra) { ns_complex::absRow<false>(n, ry, ra); }, y, a);
+}
+
+/*!
+ * split complex (SoA) layout: the real and the imaginary parts in 2 views of T.
+ * the element-wise operations on it are plain real expressions, which vectorize without shuffles.
+ */
+template<class T, u32 N>
+struct SplitView
+{
+    View<T, N>  re;
+    View<T, N>  im;
+};
+
+/* interleaved -> split */
+template<class T, u32 N>
+void split(SplitView<T, N> y, const View<complex<T>, N>& a) {
+    if (!(y.re.size() == y.im.size())) {
+        NMS_THROW(EBadSize{});
+    }
+    rowwise([](usize n, auto rre, auto rim, auto ra) {
+        for (usize i = 0; i < n; ++i) {
+            rre[i] = ra[i].r;
+            rim[i] = ra[i].i;
+        }
+    }, y.re, y.im, a);
 }
 
+/* split -> interleaved */
+template<class T, u32 N>
+void merge(View<complex<T>, N> y, const SplitView<T, N>& a) {
+    rowwise([](usize n, auto ry, auto rre, auto rim) {
+        for (usize i = 0; i < n; ++i) {
+            ry[i] = complex<T>{ rre[i], rim[i] };
+        }
+    }, y, a.re, a.im);
+}
+
+/* y = a * b in split layout, in one pass. y may be a or b. */
+template<class T, u32 N>
+void cmul(SplitView<T, N> y, const SplitView<T, N>& a, const SplitView<T, N>& b) {
+    ns_complex::mulSplit<false>(y, a, b);
+}
+
+/* y = a * ~b in split layout, in one pass. y may be a or b. */
+template<class T, u32 N>
+void cmulc(SplitView<T, N> y, const SplitView<T, N>& a, const SplitView<T, N>& b) {
+    ns_complex::mulSplit<true>(y, a, b);
+}
+
+#ifdef NMS_MATH_SSE
+/* interleaved -> split, cf32 */
+template<u32 N>
+void split(SplitView<f32, N> y, const View<cf32, N>& a) {
+    if (!(y.re.size() == y.im.size())) {
+        NMS_THROW(EBadSize{});
+    }
+    rowwise([](usize n, auto rre, auto rim, auto ra) {
+        usize i = 0;
+        if (ra.step == 1 && rre.step == 1 && rim.step == 1) {
+            const auto pa = reinterpret_cast<const f32*>(ra.data);
+            for (; i + 4 <= n; i += 4) {
+                const auto v0 = _mm_loadu_ps(pa + 2 * i + 0);
+                const auto v1 = _mm_loadu_ps(pa + 2 * i + 4);
+                _mm_storeu_ps(rre.data + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(rim.data + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+        }
+        for (; i < n; ++i) {
+            rre[i] = ra[i].r;
+            rim[i] = ra[i].i;
+        }
+    }, y.re, y.im, a);
+}
+
+/* split -> interleaved, cf32 */
+template<u32 N>
+void merge(View<cf32, N> y, const SplitView<f32, N>& a) {
+    rowwise([](usize n, auto ry, auto rre, auto rim) {
+        usize i = 0;
+        if (ry.step == 1 && rre.step == 1 && rim.step == 1) {
+            const auto py = reinterpret_cast<f32*>(ry.data);
+            for (; i + 4 <= n; i += 4) {
+                const auto re = _mm_loadu_ps(rre.data + i);
+                const auto im = _mm_loadu_ps(rim.data + i);
+                _mm_storeu_ps(py + 2 * i + 0, _mm_unpacklo_ps(re, im));
+                _mm_storeu_ps(py + 2 * i + 4, _mm_unpackhi_ps(re, im));
+            }
+        }
+        for (; i < n; ++i) {
+            ry[i] = cf32{ rre[i], rim[i] };
+        }
+    }, y, a.re, a.im);
+}
+#endif
+
+#pragma endregion
+
+}
@@ -0,0 +1,152 @@
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io/log.h>
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+nms_test(half) {
+    test::assert_eq(f16(1.0f).bits,       u16(0x3C00));
+    test::assert_eq(f16(-2.0f).bits,      u16(0xC000));
+    test::assert_eq(f16(65504.0f).bits,   u16(0x7BFF));
+    test::assert_eq(f16(65520.0f).bits,   u16(0x7C00));     // overflow: inf
+    test::assert_eq(f16(6.0e-8f).bits,    u16(0x0001));     // subnormal
+    test::assert_eq(f16(1.0e-8f).bits,    u16(0x0000));
+
+    // round half to even
+    test::assert_eq(f16(1.0f + 1.0f / 2048).bits, u16(0x3C00));
+    test::assert_eq(f16(1.0f + 3.0f / 2048).bits, u16(0x3C02));
+
+    test::assert_eq(bf16(1.0f).bits,      u16(0x3F80));
+    test::assert_eq(bf16(-3.0f).bits,     u16(0xC040));
+    test::assert_eq(f32(bf16(1.0f + 1.0f / 256)), 1.0f);  // half to even
+
+    // f16 -> f32 -> f16, bf16 -> f32 -> bf16: exact for all non-nan
+    auto errs = 0u;
+    for (u32 b = 0; b < 65536; ++b) {
+        const auto h = f16::frombits(u16(b));
+        const auto g = bf16::frombits(u16(b));
+        const auto x = f32(h);
+        const auto y = f32(g);
+        const auto u = f32(f16(x));
+        const auto v = f32(bf16(y));
+        errs += x != x ? (u != u ? 0 : 1) : (f16(x).bits  == b ? 0 : 1);
+        errs += y != y ? (v != v ? 0 : 1) : (bf16(y).bits == b ? 0 : 1);
+    }
+    test::assert_eq(errs, 0u);
+}
+
+nms_test(convert) {
+    // odd sizes: the tails of the simd loops
+    Array<u16, 2> a({ 37u, 5u });
+    Array<f32, 2> f({ 37u, 5u });
+    Array<u16, 2> b({ 37u, 5u });
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            a(i, j) = u16(i * 1771 + j * 13);
+        }
+    }
+
+    convert(f, a, 0.5, -100.0);
+    auto errs = 0u;
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            errs += f(i, j) == f32(a(i, j)) * 0.5f - 100.0f ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // back, with clamping
+    convert(b, f, 2.0, 200.0);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            errs += b(i, j) == a(i, j) ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    convert(b, f, 4.0, 1e6);
+    test::assert_eq(b(3, 3), u16(65535));
+    convert(b, f, -1.0);
+    test::assert_eq(b(30, 3), u16(0));
+
+    // simd rows == scalar (strided) rows
+    Array<u8,  2> c({ 37u, 5u });
+    Array<u8,  2> d({ 5u, 37u });
+    auto dt = d.permute({ 1u, 0u });
+    convert(c, f, 0.01, 3.0);
+    convert(dt, f, 0.01, 3.0);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 37; ++i) {
+            errs += c(i, j) == dt(i, j) ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // rounding modes, nan
+    Array<f32, 1> r({ 20u });
+    Array<i16, 1> s({ 20u });
+    const f32 vals[] = { 2.5f, 3.5f, -2.5f, -2.7f, 1e9f, -1e9f, 0.0f / 0.0f };
+    for (u32 i = 0; i < 20; ++i) {
+        r(i) = vals[i % 7];
+    }
+    convert(s, r);
+    test::assert_eq(s(0), i16(2));
+    test::assert_eq(s(1), i16(4));
+    test::assert_eq(s(2), i16(-2));
+    test::assert_eq(s(4), i16(32767));
+    test::assert_eq(s(5), i16(-32768));
+    test::assert_eq(s(6), i16(-32768));
+    for (u32 i = 0; i < 20; ++i) {
+        errs += s(i) == s(i % 7) ? 0 : 1;
+    }
+    test::assert_eq(errs, 0u);
+
+    convert(s, r, 1.0, 0.0, RoundMode::Floor);
+    test::assert_eq(s(2), i16(-3));
+    convert(s, r, 1.0, 0.0, RoundMode::Ceil);
+    test::assert_eq(s(3), i16(-2));
+    convert(s, r, 1.0, 0.0, RoundMode::Trunc);
+    test::assert_eq(s(3), i16(-2));
+    test::assert_eq(s(1), i16(3));
+
+    // i32 <-> f64, f16 storage
+    Array<i32, 1> n({ 9u });
+    Array<f64, 1> m({ 9u });
+    Array<f16, 1> h({ 9u });
+    Array<f32, 1> g({ 9u });
+    n <<= lins(-123457);
+    convert(m, n, 1.0 / 3);
+    convert(n, m, 3.0);
+    test::assert_eq(n(8), -123457 * 8);
+    convert(h, m, 1e-5);
+    convert(g, h);
+    test::assert_eq(abs(g(8) - f32(m(8) * 1e-5)) < 1e-3f * abs(g(8)), true);
+}
+
+nms_test(convert_bench) {
+    static const u32 $size = 1024;
+
+    Array<u16, 2> a({ $size, $size });
+    Array<f32, 2> y({ $size, $size });
+    Array<f32, 2> z({ $size, $size });
+    a <<= lins(u16(3), u16(5));
+
+    const auto t0 = clock();
+    y <<= a;
+    const auto t1 = clock();
+    convert(z, a);
+    const auto t2 = clock();
+    convert(a, z, 0.5);
+    const auto t3 = clock();
+
+    test::assert_eq(y(9, 7), z(9, 7));
+    io::log::info("nms.math.convert: {}x{}, u16->f32 Ass2 {:.3f} ms, u16->f32 {:.3f} ms, f32->u16 {:.3f} ms",
+        $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000, (t3 - t2) * 1000);
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <nms/core.h>
+#include <nms/math/view.h>
+#include <nms/math/half.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define NMS_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace nms::math
+{
+
+enum class RoundMode
+{
+    Nearest = 0,    // half to even
+    Floor   = 1,
+    Ceil    = 2,
+    Trunc   = 3,    // toward zero
+};
+
+namespace ns_convert
+{
+
+/* 32 bit integers and f64 are computed in f64, others in f32 */
+template<class T>
+constexpr bool isWide() {
+    return $is<f64, T> || ($is<$int, T> && sizeof(T) >= 4);
+}
+
+template<class T>
+constexpr f64 lowest() {
+    return $is<$sint, T> ? -f64(u64(1) << (sizeof(T) * 8 - 1)) : 0.0;
+}
+
+template<class T>
+constexpr f64 highest() {
+    return $is<$sint, T> ? f64((u64(1) << (sizeof(T) * 8 - 1)) - 1) : f64((u64(1) << (sizeof(T) * 8)) - 1);
+}
+
+/* round half to even: exact for |v| < 2^22 (f32), 2^51 (f64), in the default fpu rounding mode */
+__forceinline f32 rint(f32 v) noexcept {
+    return (v + 12582912.0f) - 12582912.0f;
+}
+
+__forceinline f64 rint(f64 v) noexcept {
+    return (v + 6755399441055744.0) - 6755399441055744.0;
+}
+
+/* Tc -> U: integers are clamped (nan -> lowest), then rounded */
+template<RoundMode R, class U, class Tc>
+__forceinline U cast(Tc v) noexcept {
+    if constexpr($is<$int, U>) {
+        constexpr static const auto lo = Tc(lowest<U>());
+        constexpr static const auto hi = Tc(highest<U>());
+        v = v > lo ? v : lo;
+        v = v < hi ? v : hi;
+
+        if constexpr(R == RoundMode::Nearest) return U(rint(v));
+        if constexpr(R == RoundMode::Floor)   return U(::floor(v));
+        if constexpr(R == RoundMode::Ceil)    return U(::ceil(v));
+        if constexpr(R == RoundMode::Trunc)   return U(v);
+    }
+    else if constexpr($is<f16, U> || $is<bf16, U>) {
+        return U(f32(v));
+    }
+    else {
+        return U(v);
+    }
+}
+
+/* contiguous rows with simd: returns the count of converted items */
+template<RoundMode R, class U, class T>
+usize convertSimd(usize /*n*/, U* /*y*/, const T* /*a*/, f32 /*scale*/, f32 /*offset*/) {
+    return 0;
+}
+
+#ifdef NMS_MATH_SSE2
+__forceinline __m128 affine(__m128i v, __m128 scale, __m128 offset) {
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), scale), offset);
+}
+
+/* 8 x u16|i16 -> 8 x f32 */
+template<bool Signed>
+__forceinline void widen16(f32* y, __m128i x, __m128 s, __m128 o) {
+    const auto lo = Signed ? _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16) : _mm_unpacklo_epi16(x, _mm_setzero_si128());
+    const auto hi = Signed ? _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16) : _mm_unpackhi_epi16(x, _mm_setzero_si128());
+    _mm_storeu_ps(y + 0, affine(lo, s, o));
+    _mm_storeu_ps(y + 4, affine(hi, s, o));
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, f32* y, const u16* a, f32 scale, f32 offset) {
+    const auto s = _mm_set1_ps(scale);
+    const auto o = _mm_set1_ps(offset);
+    usize i = 0;
+    for (; i + 8 <= n; i += 8) {
+        widen16<false>(y + i, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), s, o);
+    }
+    return i;
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, f32* y, const i16* a, f32 scale, f32 offset) {
+    const auto s = _mm_set1_ps(scale);
+    const auto o = _mm_set1_ps(offset);
+    usize i = 0;
+    for (; i + 8 <= n; i += 8) {
+        widen16<true>(y + i, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), s, o);
+    }
+    return i;
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, f32* y, const u8* a, f32 scale, f32 offset) {
+    const auto s = _mm_set1_ps(scale);
+    const auto o = _mm_set1_ps(offset);
+    const auto z = _mm_setzero_si128();
+    usize i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        widen16<false>(y + i + 0, _mm_unpacklo_epi8(x, z), s, o);
+        widen16<false>(y + i + 8, _mm_unpackhi_epi8(x, z), s, o);
+    }
+    return i;
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, f32* y, const i8* a, f32 scale, f32 offset) {
+    const auto s = _mm_set1_ps(scale);
+    const auto o = _mm_set1_ps(offset);
+    usize i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        widen16<true>(y + i + 0, _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8), s, o);
+        widen16<true>(y + i + 8, _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8), s, o);
+    }
+    return i;
+}
+
+/* 4 x f32 -> 4 x i32: affine, clamp (nan -> lo), round */
+template<RoundMode R>
+__forceinline __m128i narrow32(const f32* a, __m128 s, __m128 o, __m128 lo, __m128 hi) {
+    auto v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a), s), o);
+    v = _mm_min_ps(_mm_max_ps(v, lo), hi);
+    return R == RoundMode::Trunc ? _mm_cvttps_epi32(v) : _mm_cvtps_epi32(v);
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, u16* y, const f32* a, f32 scale, f32 offset) {
+    if (R == RoundMode::Floor || R == RoundMode::Ceil) {
+        return 0;
+    }
+    const auto s  = _mm_set1_ps(scale);
+    const auto o  = _mm_set1_ps(offset);
+    const auto lo = _mm_set1_ps(0.0f);
+    const auto hi = _mm_set1_ps(65535.0f);
+    const auto b  = _mm_set1_epi32(0x8000);
+    usize i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // no unsigned pack in sse2: bias to i16, pack with signed saturation, unbias
+        const auto v0 = _mm_sub_epi32(narrow32<R>(a + i + 0, s, o, lo, hi), b);
+        const auto v1 = _mm_sub_epi32(narrow32<R>(a + i + 4, s, o, lo, hi), b);
+        const auto v  = _mm_xor_si128(_mm_packs_epi32(v0, v1), _mm_set1_epi16(i16(0x8000)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), v);
+    }
+    return i;
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, i16* y, const f32* a, f32 scale, f32 offset) {
+    if (R == RoundMode::Floor || R == RoundMode::Ceil) {
+        return 0;
+    }
+    const auto s  = _mm_set1_ps(scale);
+    const auto o  = _mm_set1_ps(offset);
+    const auto lo = _mm_set1_ps(-32768.0f);
+    const auto hi = _mm_set1_ps(+32767.0f);
+    usize i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const auto v0 = narrow32<R>(a + i + 0, s, o, lo, hi);
+        const auto v1 = narrow32<R>(a + i + 4, s, o, lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), _mm_packs_epi32(v0, v1));
+    }
+    return i;
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, u8* y, const f32* a, f32 scale, f32 offset) {
+    if (R == RoundMode::Floor || R == RoundMode::Ceil) {
+        return 0;
+    }
+    const auto s  = _mm_set1_ps(scale);
+    const auto o  = _mm_set1_ps(offset);
+    const auto lo = _mm_set1_ps(0.0f);
+    const auto hi = _mm_set1_ps(255.0f);
+    usize i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto v0 = _mm_packs_epi32(narrow32<R>(a + i + 0, s, o, lo, hi), narrow32<R>(a + i +  4, s, o, lo, hi));
+        const auto v1 = _mm_packs_epi32(narrow32<R>(a + i + 8, s, o, lo, hi), narrow32<R>(a + i + 12, s, o, lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), _mm_packus_epi16(v0, v1));
+    }
+    return i;
+}
+
+template<RoundMode R>
+usize convertSimd(usize n, i8* y, const f32* a, f32 scale, f32 offset) {
+    if (R == RoundMode::Floor || R == RoundMode::Ceil) {
+        return 0;
+    }
+    const auto s  = _mm_set1_ps(scale);
+    const auto o  = _mm_set1_ps(offset);
+    const auto lo = _mm_set1_ps(-128.0f);
+    const auto hi = _mm_set1_ps(+127.0f);
+    usize i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto v0 = _mm_packs_epi32(narrow32<R>(a + i + 0, s, o, lo, hi), narrow32<R>(a + i +  4, s, o, lo, hi));
+        const auto v1 = _mm_packs_epi32(narrow32<R>(a + i + 8, s, o, lo, hi), narrow32<R>(a + i + 12, s, o, lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), _mm_packs_epi16(v0, v1));
+    }
+    return i;
+}
+#endif
+
+template<RoundMode R, class U, class T, u32 N>
+void convert(View<U, N>& y, const View<T, N>& a, f64 scale, f64 offset) {
+    using Tc = Tcond<isWide<T>() || isWide<U>(), f64, f32>;
+
+    const auto s = Tc(scale);
+    const auto o = Tc(offset);
+    rowwise([=](usize n, ViewRow<U> ry, ViewRow<T> ra) {
+        usize i = 0;
+        if (ry.step == 1 && ra.step == 1 && $is<f32, Tc>) {
+            i = convertSimd<R>(n, ry.data, ra.data, f32(s), f32(o));
+        }
+        for (; i < n; ++i) {
+            ry[i] = cast<R, U>(Tc(ra[i]) * s + o);
+        }
+    }, y, a);
+}
+
+}
+
+/*!
+ * y = a * scale + offset, item-wise, with saturation.
+ * integer results are clamped to the range of U (nan -> the lowest), and rounded by `mode`.
+ * float results (f16, bf16, f32, f64) are IEEE rounded: f16 overflows to inf.
+ * 32 bit integers and f64 are computed in f64, others in f32.
+ * the u8/i8/u16/i16 <-> f32 rows are converted with sse2 if contiguous.
+ */
+template<class U, class T, u32 N>
+void convert(View<U, N> y, const View<T, N>& a, f64 scale = 1.0, f64 offset = 0.0, RoundMode mode = RoundMode::Nearest) {
+    static_assert(!$is<$int, U> || sizeof(U) <= 4, "nms.math.convert: 64 bit integer is not supported");
+
+    switch (mode) {
+    case RoundMode::Nearest: ns_convert::convert<RoundMode::Nearest>(y, a, scale, offset); break;
+    case RoundMode::Floor:   ns_convert::convert<RoundMode::Floor>  (y, a, scale, offset); break;
+    case RoundMode::Ceil:    ns_convert::convert<RoundMode::Ceil>   (y, a, scale, offset); break;
+    case RoundMode::Trunc:   ns_convert::convert<RoundMode::Trunc>  (y, a, scale, offset); break;
+    default:
+        NMS_THROW(EInvalidValue{});
+    }
+}
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <nms/core.h>
+
+namespace nms::math
+{
+
+namespace ns_half
+{
+
+union Tcast
+{
+    f32 f;
+    u32 u;
+};
+
+__forceinline u32 bits(f32 f) noexcept {
+    Tcast c;
+    c.f = f;
+    return c.u;
+}
+
+__forceinline f32 real(u32 u) noexcept {
+    Tcast c;
+    c.u = u;
+    return c.f;
+}
+
+/* f32 -> binary16, round to nearest even. overflow -> inf, nan is kept */
+inline u16 f32ToF16(f32 f) noexcept {
+    const auto x    = bits(f);
+    const auto sign = (x >> 16) & 0x8000u;
+    auto       ax   = x & 0x7FFFFFFFu;
+
+    if (ax >= 0x7F800000u) {
+        return u16(sign | 0x7C00u | (ax > 0x7F800000u ? 0x200u | ((ax >> 13) & 0x3FFu) : 0u));
+    }
+    if (ax >= 0x477FF000u) {            // >= 65520: rounds to inf
+        return u16(sign | 0x7C00u);
+    }
+    if (ax < 0x38800000u) {             // < 2^-14: subnormal, the fpu rounds the mantissa
+        const auto t = real(ax) + 0.5f;
+        return u16(sign | (bits(t) - 0x3F000000u));
+    }
+    const auto odd = (ax >> 13) & 1u;
+    ax += 0xC8000FFFu + odd;            // rebias exponent (-112 << 23), round half to even
+    return u16(sign | (ax >> 13));
+}
+
+/* binary16 -> f32, exact */
+inline f32 f16ToF32(u16 h) noexcept {
+    const auto sign = u32(h & 0x8000u) << 16;
+    const auto em   = u32(h & 0x7FFFu);
+
+    if (em >= 0x7C00u) {
+        return real(sign | 0x7F800000u | ((em & 0x3FFu) << 13));
+    }
+    if (em >= 0x0400u) {
+        return real(sign | ((em << 13) + 0x38000000u));
+    }
+    return real(sign | bits(f32(em) * (1.0f / 16777216.0f)));
+}
+
+/* f32 -> bfloat16, round to nearest even. nan is kept quiet */
+inline u16 f32ToBf16(f32 f) noexcept {
+    const auto x = bits(f);
+    if ((x & 0x7FFFFFFFu) > 0x7F800000u) {
+        return u16((x >> 16) | 0x40u);
+    }
+    return u16((x + 0x7FFFu + ((x >> 16) & 1u)) >> 16);
+}
+
+/* bfloat16 -> f32, exact */
+__forceinline f32 bf16ToF32(u16 h) noexcept {
+    return real(u32(h) << 16);
+}
+
+}
+
+/*!
+ * IEEE 754 binary16: 1 sign, 5 exponent, 10 mantissa bits.
+ * a storage type: it converts to f32 implicitly, arithmetic is done in f32.
+ */
+struct f16
+{
+    u16 bits;
+
+    f16() = default;
+
+    f16(f32 f) noexcept
+        : bits(ns_half::f32ToF16(f))
+    {}
+
+    static f16 frombits(u16 b) noexcept {
+        f16 h;
+        h.bits = b;
+        return h;
+    }
+
+    operator f32() const noexcept {
+        return ns_half::f16ToF32(bits);
+    }
+};
+
+/*!
+ * bfloat16: the high 16 bits of f32, 1 sign, 8 exponent, 7 mantissa bits.
+ * the range of f32 with less precision. a storage type, like f16.
+ */
+struct bf16
+{
+    u16 bits;
+
+    bf16() = default;
+
+    bf16(f32 f) noexcept
+        : bits(ns_half::f32ToBf16(f))
+    {}
+
+    static bf16 frombits(u16 b) noexcept {
+        bf16 h;
+        h.bits = b;
+        return h;
+    }
+
+    operator f32() const noexcept {
+        return ns_half::bf16ToF32(bits);
+    }
+};
+
+}
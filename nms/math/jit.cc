@@ -0,0 +1,361 @@
+#include <nms/config.h>
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io.h>
+#include <nms/util/library.h>
+
+#ifdef NMS_OS_UNIX
+#include <sys/utsname.h>
+#endif
+
+namespace nms::math::ns_jit
+{
+
+/* the functions of math/base.h, by name */
+static const char gPrelude[] = R"(
+#include <cmath>
+
+namespace nms_jit
+{
+template<class X, class Y> inline auto Add(X x, Y y)  { return x + y; }
+template<class X, class Y> inline auto Sub(X x, Y y)  { return x - y; }
+template<class X, class Y> inline auto Mul(X x, Y y)  { return x * y; }
+template<class X, class Y> inline auto Div(X x, Y y)  { return x / y; }
+template<class X, class Y> inline auto Min(X x, Y y)  { return x < y ? x : y; }
+template<class X, class Y> inline auto Max(X x, Y y)  { return x > y ? x : y; }
+template<class X, class Y> inline auto Pow(X x, Y y)  { return std::pow(x, y); }
+
+template<class X, class Y> inline auto Eq (X x, Y y)  { return x == y; }
+template<class X, class Y> inline auto Neq(X x, Y y)  { return x != y; }
+template<class X, class Y> inline auto Lt (X x, Y y)  { return x <  y; }
+template<class X, class Y> inline auto Gt (X x, Y y)  { return x >  y; }
+template<class X, class Y> inline auto Le (X x, Y y)  { return x <= y; }
+template<class X, class Y> inline auto Ge (X x, Y y)  { return x >= y; }
+template<class X, class Y> inline auto And(X x, Y y)  { return x && y; }
+template<class X, class Y> inline auto Or (X x, Y y)  { return x || y; }
+
+template<class T> inline auto Pos  (T t) { return +t; }
+template<class T> inline auto Neg  (T t) { return -t; }
+template<class T> inline auto Abs  (T t) { return t < 0 ? -t : t; }
+template<class T> inline auto Pow2 (T t) { return t * t; }
+template<class T> inline auto Sqrt (T t) { return std::sqrt(t);  }
+template<class T> inline auto Exp  (T t) { return std::exp(t);   }
+template<class T> inline auto Ln   (T t) { return std::log(t);   }
+template<class T> inline auto Log10(T t) { return std::log10(t); }
+template<class T> inline auto Sin  (T t) { return std::sin(t);   }
+template<class T> inline auto Cos  (T t) { return std::cos(t);   }
+template<class T> inline auto Tan  (T t) { return std::tan(t);   }
+template<class T> inline auto Asin (T t) { return std::asin(t);  }
+template<class T> inline auto Acos (T t) { return std::acos(t);  }
+template<class T> inline auto Atan (T t) { return std::atan(t);  }
+
+template<class Y, class X> inline void Ass2(Y& y, X x) { y  = x; }
+template<class Y, class X> inline void Add2(Y& y, X x) { y += x; }
+template<class Y, class X> inline void Sub2(Y& y, X x) { y -= x; }
+template<class Y, class X> inline void Mul2(Y& y, X x) { y *= x; }
+template<class Y, class X> inline void Div2(Y& y, X x) { y /= x; }
+}
+
+using namespace nms_jit;
+
+#ifdef _WIN32
+extern "C" __declspec(dllexport)
+#else
+extern "C"
+#endif
+void nms_jit_kernel(const unsigned long long* n, void* const* p, const long long* s, const double* r) {
+(void)p; (void)s; (void)r;
+)";
+
+NMS_API StrView shortName(StrView name) {
+    auto pos = name.count();
+    while (pos > 0 && name[pos - 1] != ':') {
+        --pos;
+    }
+    return { name.data() + pos, name.count() - pos };
+}
+
+/*!
+ * the per-user kernel cache: $XDG_CACHE_HOME/nms-jit or ~/.cache/nms-jit (%LOCALAPPDATA%\nms-jit on windows).
+ * only the user can write it, so a cached library is never planted by someone else.
+ * empty if not available: the expressions are interpreted.
+ */
+static String cacheDir() {
+#ifdef NMS_OS_WINDOWS
+    const auto base = ::getenv("LOCALAPPDATA");
+    if (base == nullptr) {
+        return {};
+    }
+    String dir = StrView(base, u32(strlen(base)));
+    dir += StrView("\\nms-jit");
+    if (::_mkdir(dir.cstr()) != 0 && errno != EEXIST) {
+        return {};
+    }
+    return dir;
+#else
+    String dir;
+    const auto xdg  = ::getenv("XDG_CACHE_HOME");
+    const auto home = ::getenv("HOME");
+    if (xdg != nullptr && xdg[0] == '/') {
+        dir = StrView(xdg, u32(strlen(xdg)));
+    }
+    else if (home != nullptr && home[0] == '/') {
+        dir = StrView(home, u32(strlen(home)));
+        dir += StrView("/.cache");
+        ::mkdir(dir.cstr(), 0700);
+    }
+    else {
+        return {};
+    }
+    dir += StrView("/nms-jit");
+    ::mkdir(dir.cstr(), 0700);
+
+    // a directory of this user, not a link, and private
+    struct stat st;
+    if (::lstat(dir.cstr(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != ::getuid()) {
+        io::log::warn("nms.math.jit: cache '{}' is not a directory of the user", dir);
+        return {};
+    }
+    if ((st.st_mode & 077) != 0 && ::chmod(dir.cstr(), 0700) != 0) {
+        return {};
+    }
+    return dir;
+#endif
+}
+
+/* the machine the kernels are built for (-march=native): a cache may be shared by hosts, e.g. nfs home */
+static String targetName() {
+#ifdef NMS_OS_WINDOWS
+    const auto cpu  = ::getenv("PROCESSOR_IDENTIFIER");
+    const auto host = ::getenv("COMPUTERNAME");
+    return format("{}/{}", cpu  != nullptr ? StrView(cpu,  u32(strlen(cpu)))  : StrView("?"),
+                           host != nullptr ? StrView(host, u32(strlen(host))) : StrView("?"));
+#else
+    struct utsname un;
+    if (::uname(&un) != 0) {
+        return {};
+    }
+    return format("{}/{}/{}", StrView(un.sysname, u32(strlen(un.sysname))),
+        StrView(un.machine, u32(strlen(un.machine))), StrView(un.nodename, u32(strlen(un.nodename))));
+#endif
+}
+
+/* a path as one shell word */
+static String quote(StrView path) {
+    String ret;
+#ifdef NMS_OS_WINDOWS
+    ret += StrView("\"");
+    ret += path;
+    ret += StrView("\"");
+#else
+    ret += StrView("'");
+    for (auto c : path) {
+        if (c == '\'') {
+            ret += StrView("'\\''");
+        }
+        else {
+            ret += c;
+        }
+    }
+    ret += StrView("'");
+#endif
+    return ret;
+}
+
+/* $NMS_JIT_CXX, or the default compiler */
+static StrView compiler() {
+    const auto env = ::getenv("NMS_JIT_CXX");
+    if (env != nullptr) {
+        return { env, u32(strlen(env)) };
+    }
+#ifdef NMS_CC_MSVC
+    return "cl";
+#else
+    return "c++";
+#endif
+}
+
+static const String& cachePath() {
+    static const auto dir = cacheDir();
+    return dir;
+}
+
+NMS_API bool available() {
+    static const auto ret = [] {
+        if (cachePath().count() == 0) {
+            return false;
+        }
+#ifdef NMS_CC_MSVC
+        const auto cmd = format("{} /? > nul 2>&1", compiler());
+#elif defined(NMS_OS_WINDOWS)
+        const auto cmd = format("{} --version > nul 2>&1", compiler());
+#else
+        const auto cmd = format("{} --version > /dev/null 2>&1", compiler());
+#endif
+        return ::system(cmd.cstr()) == 0;
+    }();
+    return ret;
+}
+
+NMS_API Tkernel compile(StrView body) {
+    const auto& dir = cachePath();
+    if (dir.count() == 0) {
+        return nullptr;
+    }
+
+    String src;
+    src += StrView(gPrelude);
+    src += body;
+    src += StrView("}\n");
+
+    // the compiler, the flags and the target are part of the key
+    const auto cxx = compiler();
+#ifdef NMS_CC_MSVC
+    static const char $ext[] = "dll";
+    const auto cmd = format("{} /nologo /O2 /LD", cxx);
+#else
+#ifdef NMS_OS_WINDOWS
+    static const char $ext[] = "dll";
+#else
+    static const char $ext[] = "so";
+#endif
+    const auto cmd = format("{} -std=c++14 -O3 -march=native -shared -fPIC", cxx);
+#endif
+    static const auto target = targetName();
+    const auto hash     = strhash(StrView(format("{}\n{}\n{}", cmd, target, src)));
+    const auto lib_path = format("{}/nms.jit.{}.{}", dir, hash, $ext);
+
+    if (!io::exists(lib_path)) {
+        // private names: processes building the same kernel do not clash
+#ifdef NMS_OS_WINDOWS
+        const auto pid = u32(::_getpid());
+#else
+        const auto pid = u32(::getpid());
+#endif
+        const auto src_path = format("{}/nms.jit.{}.{}.cc",     dir, hash, pid);
+        const auto tmp_path = format("{}/nms.jit.{}.{}.tmp.{}", dir, hash, pid, $ext);
+        const auto log_path = format("{}/nms.jit.{}.{}.log",    dir, hash, pid);
+        {
+            io::TxtFile file(src_path, io::File::Write);
+            file.write(StrView(src));
+        }
+
+#ifdef NMS_CC_MSVC
+        const auto cmd_line = format("{} /Fe{} {} > {} 2>&1", cmd, quote(tmp_path), quote(src_path), quote(log_path));
+#else
+        const auto cmd_line = format("{} -o {} {} > {} 2>&1", cmd, quote(tmp_path), quote(src_path), quote(log_path));
+#endif
+        const auto ret = ::system(cmd_line.cstr());
+        if (ret != 0 || !io::exists(tmp_path)) {
+            io::log::warn("nms.math.jit: compile {} failed, see {}", src_path, log_path);
+            return nullptr;
+        }
+        io::rename(tmp_path, lib_path);
+        io::remove(src_path);
+        io::remove(log_path);
+    }
+
+    // never unloaded: the kernels are cached for the process lifetime
+    const auto lib = new(mnew<Library>(1))Library(lib_path);
+    const auto fun = (*lib)[StrView("nms_jit_kernel")];
+    if (!fun) {
+        return nullptr;
+    }
+    return static_cast<Tkernel>(fun);
+}
+
+}
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+/* build the kernel of `ret func= x`, as Tjit does */
+template<class F, class X>
+static bool jitBuilt(View<f32, 2> ret, const X& x) {
+    using Targ = Broadcast<decltype(view_cast(x))>;
+    return ns_jit::build<F>(ret, Targ(view_cast(x))) != nullptr;
+}
+
+nms_test(jit) {
+    if (!ns_jit::available()) {
+        io::log::warn("nms.math.jit: no compiler or cache directory, skipped");
+        return;
+    }
+
+    Array<f32, 2> a({ 37u, 21u });
+    Array<f32, 2> b({ 37u, 21u });
+    Array<f32, 1> r({ 37u });
+    Array<f32, 2> y({ 37u, 21u });
+    Array<f32, 2> z({ 37u, 21u });
+    a <<= lins(1.0f, 10.0f);
+    b <<= lins(0.1f, 0.2f);
+    r <<= lins(0.5f);
+
+    // the kernels are built, not interpreted
+    test::assert_eq(jitBuilt<Ass2>(a, a * 2.0f + vsin(b) - r), true);
+    test::assert_eq(jitBuilt<Ass2>(a, a + lins(1.0f, 2.0f)), false);
+
+    // same expression type: the kernel is compiled once
+    auto errs = 0u;
+    for (u32 k = 0; k < 2; ++k) {
+        const auto c = 2.0f + k;
+        y <<= a * c + vsin(b) - r;
+        z <<= jit(a * c + vsin(b) - r);
+
+        for (u32 j = 0; j < 21; ++j) {
+            for (u32 i = 0; i < 37; ++i) {
+                errs += abs(y(i, j) - z(i, j)) <= 1e-4f * abs(y(i, j)) ? 0 : 1;
+            }
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // strided view, update
+    auto t = b.permute({ 1u, 0u });
+    Array<f32, 2> w({ 21u, 37u });
+    Array<f32, 2> v({ 21u, 37u });
+    w <<= 1.0f;
+    v <<= 1.0f;
+    test::assert_eq(jitBuilt<Add2>(v, t * 3), true);
+    w += t * 3;
+    v += jit(t * 3);
+    for (u32 j = 0; j < 37; ++j) {
+        for (u32 i = 0; i < 21; ++i) {
+            errs += w(i, j) == v(i, j) ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // unsupported: interpreted
+    z <<= jit(a + lins(1.0f, 2.0f));
+    test::assert_eq(z(3, 4), a(3, 4) + 3.0f + 8.0f);
+}
+
+nms_test(jit_bench) {
+    static const u32 $size = 1024;
+
+    Array<f32, 2> a({ $size, $size });
+    Array<f32, 2> b({ $size, $size });
+    Array<f32, 2> y({ $size, $size });
+    Array<f32, 2> z({ $size, $size });
+    a <<= lins(1.0f, 2.0f);
+    b <<= lins(0.5f, 0.25f);
+
+    const auto t0 = clock();
+    z <<= jit(a * b + a / 3.0f - b);
+    const auto t1 = clock();
+    y <<= a * b + a / 3.0f - b;
+    const auto t2 = clock();
+    z <<= jit(a * b + a / 3.0f - b);
+    const auto t3 = clock();
+
+    test::assert_eq(z(5, 7), y(5, 7));
+    io::log::info("nms.math.jit: {}x{} f32: first call {:.3f} ms, interpreted {:.3f} ms, compiled {:.3f} ms",
+        $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000, (t3 - t2) * 1000);
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <nms/core.h>
+#include <nms/math/view.h>
+
+namespace nms::math
+{
+
+struct Tjit;
+
+namespace ns_jit
+{
+
+/* compiled kernel: dims, data pointers, ints (strides, masks), reals (scalars) */
+using Tkernel = void(*)(const u64* dims, void* const* ptrs, const i64* ints, const f64* reals);
+
+/* arguments of a kernel, and its source if `src` is not nullptr */
+struct Context
+{
+    constexpr static const u32 $ptrs  = 32;
+    constexpr static const u32 $ints  = 256;
+    constexpr static const u32 $reals = 32;
+
+    String* src   = nullptr;
+    u32     nptr  = 0;
+    u32     nint  = 0;
+    u32     nreal = 0;
+    void*   ptrs [$ptrs];
+    i64     ints [$ints];
+    f64     reals[$reals];
+};
+
+/*!
+ * compile the body of a kernel to a shared library, and load it.
+ * the library is cached in a private per-user directory, keyed by the hash of the source, the compiler
+ * command line and the target: the next process loads it without compiling.
+ * the compiler is $NMS_JIT_CXX, or c++ (cl on windows).
+ * returns nullptr if failed.
+ */
+NMS_API Tkernel compile(StrView body);
+
+/* test if kernels can be built: the compiler runs, and the cache directory is usable */
+NMS_API bool available();
+
+/* the name without namespaces: nms::math::Add -> Add */
+NMS_API StrView shortName(StrView name);
+
+/*!
+ * walk an expression tree: collect the arguments, and write the source with the index expressions `idx`.
+ * the walk order is the same for the same type, so the arguments of a call match the compiled kernel.
+ */
+struct Emit
+{
+    /* unsupported: the expression is interpreted */
+    template<class X>
+    static bool run(Context&, const X&, const String*) {
+        return false;
+    }
+
+    template<class T, u32 N>
+    static bool run(Context& ctx, const View<T, N>& v, const String* idx) {
+        if (ctx.nptr + 1 > Context::$ptrs || ctx.nint + N > Context::$ints) {
+            return false;
+        }
+
+        if (ctx.src != nullptr) {
+            sformat(*ctx.src, "(({}*)p[{}])[0", typeof<T>().name(), ctx.nptr);
+            for (u32 d = 0; d < N; ++d) {
+                sformat(*ctx.src, " + {}*s[{}]", StrView(idx[d]), ctx.nint + d);
+            }
+            *ctx.src += StrView("]");
+        }
+
+        ctx.ptrs[ctx.nptr++] = const_cast<void*>(static_cast<const void*>(v.data()));
+        for (u32 d = 0; d < N; ++d) {
+            ctx.ints[ctx.nint++] = i64(v.stride(d));
+        }
+        return true;
+    }
+
+    template<class T>
+    static bool run(Context& ctx, const Scalar<T>& v, const String*) {
+        if constexpr($is<$float, T>) {
+            if (ctx.nreal + 1 > Context::$reals) {
+                return false;
+            }
+            if (ctx.src != nullptr) {
+                sformat(*ctx.src, "(({})r[{}])", typeof<T>().name(), ctx.nreal);
+            }
+            ctx.reals[ctx.nreal++] = f64(v());
+            return true;
+        }
+        else if constexpr($is<$int, T>) {
+            if (ctx.nint + 1 > Context::$ints) {
+                return false;
+            }
+            if (ctx.src != nullptr) {
+                sformat(*ctx.src, "(({})s[{}])", typeof<T>().name(), ctx.nint);
+            }
+            ctx.ints[ctx.nint++] = i64(v());
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+
+    template<class X>
+    static bool run(Context& ctx, const Broadcast<X>& v, const String* idx) {
+        constexpr static const u32 M = X::$rank;
+
+        if constexpr(M == 0) {
+            return run(ctx, v.x_, idx);
+        }
+        else {
+            if (ctx.nint + M > Context::$ints) {
+                return false;
+            }
+
+            String sub[M];
+            for (u32 d = 0; d < M; ++d) {
+                if (ctx.src != nullptr) {
+                    sformat(sub[d], "({} & s[{}])", StrView(idx[d]), ctx.nint);
+                }
+                ctx.ints[ctx.nint++] = i64(v.mask_[d]);
+            }
+            return run(ctx, v.x_, sub);
+        }
+    }
+
+    template<class F, class T>
+    static bool run(Context& ctx, const Parallel<F, T>& v, const String* idx) {
+        if (ctx.src != nullptr) {
+            *ctx.src += shortName(typeof<F>().name());
+            *ctx.src += StrView("(");
+        }
+        if (!run(ctx, v.t_, idx)) {
+            return false;
+        }
+        if (ctx.src != nullptr) {
+            *ctx.src += StrView(")");
+        }
+        return true;
+    }
+
+    template<class F, class X, class Y>
+    static bool run(Context& ctx, const Parallel<F, X, Y>& v, const String* idx) {
+        if (ctx.src != nullptr) {
+            *ctx.src += shortName(typeof<F>().name());
+            *ctx.src += StrView("(");
+        }
+        if (!run(ctx, v.x_, idx)) {
+            return false;
+        }
+        if (ctx.src != nullptr) {
+            *ctx.src += StrView(", ");
+        }
+        if (!run(ctx, v.y_, idx)) {
+            return false;
+        }
+        if (ctx.src != nullptr) {
+            *ctx.src += StrView(")");
+        }
+        return true;
+    }
+};
+
+/* generate and compile the kernel of `func(ret, arg)` */
+template<class Tfunc, class Tret, class Targ>
+Tkernel build(const Tret& ret, const Targ& arg) {
+    constexpr static const u32 N = Tret::$rank;
+
+    String  src;
+    String  idx[N];
+    Context ctx;
+    ctx.src = &src;
+
+    for (u32 d = N; d-- > 0; ) {
+        sformat(idx[d], "i{}", d);
+        sformat(src, "for (unsigned long long i{} = 0; i{} < n[{}]; ++i{})\n", d, d, d, d);
+    }
+    src += shortName(typeof<Tfunc>().name());
+    src += StrView("(");
+    if (!Emit::run(ctx, ret, idx)) {
+        return nullptr;
+    }
+    src += StrView(", ");
+    if (!Emit::run(ctx, arg, idx)) {
+        return nullptr;
+    }
+    src += StrView(");\n");
+
+    return compile(src);
+}
+
+}
+
+/*!
+ * expression compiled to machine code at its first use, see jit().
+ * the kernel is generated from the expression type, so the views and scalars may change between calls.
+ */
+template<class X>
+struct Jit
+{
+    using Tview = Jit;
+    using Texec = Tjit;
+
+    constexpr static const auto $rank = X::$rank;
+
+    Jit(const X& x)
+        : x_(x)
+    {}
+
+    template<class I>
+    auto size(I idx) const noexcept {
+        return x_.size(idx);
+    }
+
+    template<class ...I>
+    auto operator()(I ...idx) const noexcept {
+        return x_(idx...);
+    }
+
+    const X& base() const noexcept {
+        return x_;
+    }
+
+protected:
+    X   x_;
+};
+
+/*!
+ * mark a hot expression to be compiled: `y <<= jit(x * 2 + vsin(z))`.
+ * supported: views, number scalars, and the functions of math/base.h.
+ * others (e.g. lins, reduce) fall back to the interpreter.
+ */
+template<class X>
+auto jit(const X& x) -> Jit<decltype(view_cast(x))> {
+    return { view_cast(x) };
+}
+
+/* jit executor */
+struct Tjit
+{
+    template<class Tfunc, class T, u32 N, class X>
+    void foreach(Tfunc func, View<T, N>& ret, const Jit<X>& arg) {
+        using Targ = Broadcast<X>;
+
+        // one kernel per expression type
+        static const auto kernel = ns_jit::build<Tfunc>(ret, Targ(arg.base()));
+        if (kernel == nullptr) {
+            Texec{}.foreach(func, ret, arg.base());
+            return;
+        }
+
+        ns_jit::Context ctx;
+        ns_jit::Emit::run(ctx, ret, nullptr);
+        ns_jit::Emit::run(ctx, Targ(arg.base()), nullptr);
+
+        u64 dims[N];
+        for (u32 d = 0; d < N; ++d) {
+            dims[d] = ret.size(d);
+        }
+        kernel(dims, ctx.ptrs, ctx.ints, ctx.reals);
+    }
+
+    template<class Tfunc, class Tret, class ...Targs>
+    void foreach(Tfunc func, Tret& ret, const Targs& ...args) {
+        Texec{}.foreach(func, ret, args...);
+    }
+};
+
+inline Tjit operator||(const Texec&, const Tjit&) {
+    return {};
+}
+
+inline Tjit operator||(const Tjit&, const Texec&) {
+    return {};
+}
+
+inline Tjit operator||(const Tjit&, const Tjit&) {
+    return {};
+}
+
+}
@@ -0,0 +1,141 @@
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io/log.h>
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+nms_test(random_philox) {
+    // known answers of Random123
+    u32 x[4] = { 0u, 0u, 0u, 0u };
+    ns_random::philox(x, 0u, 0u);
+    test::assert_eq(x[0], 0x6627e8d5u);
+    test::assert_eq(x[1], 0xe169c58du);
+    test::assert_eq(x[2], 0xbc57ac4cu);
+    test::assert_eq(x[3], 0x9b00dbd8u);
+
+    u32 y[4] = { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u };
+    ns_random::philox(y, 0xa4093822u, 0x299f31d0u);
+    test::assert_eq(y[0], 0xd16cfe09u);
+    test::assert_eq(y[1], 0x94fdccebu);
+    test::assert_eq(y[2], 0x5001e420u);
+    test::assert_eq(y[3], 0x24126ea1u);
+}
+
+nms_test(random) {
+    Array<f32, 2> a({ 255u, 129u });
+    Array<f32, 2> b({ 255u, 129u });
+
+    // reproducible: the row path of Trand == the item-wise path
+    a <<= randu(42u, -1.0f, 3.0f);
+    b <<= randu(42u, -1.0f, 3.0f) + 0.0f;
+    auto errs = 0u;
+    auto sum  = 0.0;
+    for (u32 j = 0; j < 129; ++j) {
+        for (u32 i = 0; i < 255; ++i) {
+            errs += a(i, j) == b(i, j) ? 0 : 1;
+            errs += a(i, j) >= -1.0f && a(i, j) < 3.0f ? 0 : 1;
+            sum  += a(i, j);
+        }
+    }
+    test::assert_eq(errs, 0u);
+    test::assert_eq(abs(sum / a.count() - 1.0) < 0.02);
+
+    // any order: a transposed view gets the same items
+    Array<f32, 2> c({ 129u, 255u });
+    auto ct = c.permute({ 1u, 0u });
+    ct <<= randu(42u, -1.0f, 3.0f);
+    for (u32 j = 0; j < 129; ++j) {
+        for (u32 i = 0; i < 255; ++i) {
+            errs += a(i, j) == ct(i, j) ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // another seed or stream: other items
+    b <<= randu(43u, -1.0f, 3.0f);
+    auto same_seed   = 0u;
+    auto same_stream = 0u;
+    for (u32 j = 0; j < 129; ++j) {
+        for (u32 i = 0; i < 255; ++i) {
+            same_seed   += a(i, j) == b(i, j) ? 1 : 0;
+        }
+    }
+    Array<f32, 2> d({ 255u, 129u });
+    d <<= randu(42u, -1.0f, 3.0f).stream(1);
+    for (u32 j = 0; j < 129; ++j) {
+        for (u32 i = 0; i < 255; ++i) {
+            same_stream += a(i, j) == d(i, j) ? 1 : 0;
+        }
+    }
+    test::assert_eq(same_seed < 100);
+    test::assert_eq(same_stream < 100);
+
+    // integers
+    Array<i32, 1> e({ 1000u });
+    e <<= randu(7u, -5, 5);
+    for (u32 i = 0; i < 1000; ++i) {
+        errs += e(i) >= -5 && e(i) < 5 ? 0 : 1;
+    }
+    test::assert_eq(errs, 0u);
+}
+
+nms_test(random_dist) {
+    static const u32 $count = 256 * 1024;
+
+    Array<f64, 1> a({ $count });
+
+    // normal: mean, variance
+    a <<= randn(1u, 2.0, 3.0);
+    auto s1 = 0.0;
+    auto s2 = 0.0;
+    for (u32 i = 0; i < $count; ++i) {
+        s1 += a(i);
+        s2 += a(i) * a(i);
+    }
+    const auto mean = s1 / $count;
+    const auto var  = s2 / $count - mean * mean;
+    test::assert_eq(abs(mean - 2.0) < 0.03);
+    test::assert_eq(abs(var  - 9.0) < 0.1);
+
+    // exponential: mean 1/lambda
+    a <<= rande(2u, 4.0);
+    s1 = 0.0;
+    auto errs = 0u;
+    for (u32 i = 0; i < $count; ++i) {
+        s1   += a(i);
+        errs += a(i) >= 0.0 ? 0 : 1;
+    }
+    test::assert_eq(errs, 0u);
+    test::assert_eq(abs(s1 / $count - 0.25) < 0.005);
+
+    // as an operand
+    Array<f64, 1> b({ $count });
+    b <<= lins(1.0) + randn(1u, 2.0, 3.0);
+    a <<= randn(1u, 2.0, 3.0);
+    test::assert_eq(b(100), a(100) + 100.0);
+}
+
+nms_test(random_bench) {
+    static const u32 $size = 1024;
+
+    Array<f32, 2> a({ $size, $size });
+    Array<f32, 2> b({ $size, $size });
+
+    const auto t0 = clock();
+    a <<= randu(1u, 0.0f, 1.0f);
+    const auto t1 = clock();
+    b <<= randn(1u, 0.0f, 1.0f);
+    const auto t2 = clock();
+    b <<= randn(1u, 0.0f, 1.0f) * 1.0f;
+    const auto t3 = clock();
+
+    io::log::info("nms.math.random: {}x{} f32, uniform {:.3f} ms, normal {:.3f} ms, normal item-wise {:.3f} ms",
+        $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000, (t3 - t2) * 1000);
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <nms/core.h>
+#include <nms/math/base.h>
+#include <nms/math/view.h>
+
+namespace nms::math
+{
+
+struct Trand;
+
+namespace ns_random
+{
+
+/* 32x32 -> 64 bit multiply */
+__forceinline void mulhilo(u32 a, u32 b, u32& hi, u32& lo) noexcept {
+    const auto p = u64(a) * u64(b);
+    hi = u32(p >> 32);
+    lo = u32(p);
+}
+
+/*!
+ * Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+ * a bijection of the 128 bit counter, keyed by 64 bits: the same counter always gives the same 4 numbers.
+ */
+__forceinline void philox(u32 (&ctr)[4], u32 k0, u32 k1) noexcept {
+    for (u32 r = 0; r < 10; ++r) {
+        u32 hi0, lo0, hi1, lo1;
+        mulhilo(0xD2511F53u, ctr[0], hi0, lo0);
+        mulhilo(0xCD9E8D57u, ctr[2], hi1, lo1);
+
+        const u32 out[4] = { hi1 ^ ctr[1] ^ k0, lo1, hi0 ^ ctr[3] ^ k1, lo0 };
+        ctr[0] = out[0];
+        ctr[1] = out[1];
+        ctr[2] = out[2];
+        ctr[3] = out[3];
+
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+}
+
+/* [0, 1) */
+template<class T>
+__forceinline T toUnit(u32 x) noexcept {
+    return T(x >> 8) * T(1.0 / 16777216.0);
+}
+
+/* (0, 1] */
+template<class T>
+__forceinline T toUnitOpen(u32 x) noexcept {
+    return T((x >> 8) + 1) * T(1.0 / 16777216.0);
+}
+
+}
+
+/* uniform distribution in [lo, hi) */
+template<class T>
+struct Uniform
+{
+    T lo;
+    T hi;
+
+    /* the `lane`-th number of a 4 x 32 bits block */
+    __forceinline T run(const u32(&x)[4], u32 lane) const noexcept {
+        if constexpr($is<$float, T>) {
+            return lo + (hi - lo) * ns_random::toUnit<T>(x[lane]);
+        }
+        else {
+            // multiply-shift: no division
+            const auto range = u64(hi - lo);
+            return lo + T((u64(x[lane]) * range) >> 32);
+        }
+    }
+};
+
+/* normal distribution: Box-Muller, the lanes (0,1) and (2,3) are pairs */
+template<class T>
+struct Normal
+{
+    T mean;
+    T sigma;
+
+    __forceinline T run(const u32(&x)[4], u32 lane) const noexcept {
+        constexpr static const auto $2pi = T(6.283185307179586);
+
+        const auto pair = lane & ~1u;
+        const auto r    = sqrt(T(-2) * ln(ns_random::toUnitOpen<T>(x[pair])));
+        const auto t    = $2pi * ns_random::toUnit<T>(x[pair + 1]);
+        return mean + sigma * r * ((lane & 1) == 0 ? cos(t) : sin(t));
+    }
+};
+
+/* exponential distribution, rate `lambda` */
+template<class T>
+struct Exponential
+{
+    T lambda;
+
+    __forceinline T run(const u32(&x)[4], u32 lane) const noexcept {
+        return -ln(ns_random::toUnitOpen<T>(x[lane])) / lambda;
+    }
+};
+
+/*!
+ * counter based random view.
+ * the item at (i0, i1, i2, i3) is a pure function of (seed, stream, index):
+ *   philox(counter = { i0/4, i1, i2, stream ^ i3<<16 }, key = seed), lane i0%4.
+ * so it is reproducible in any order, by any count of threads;
+ * and streams (e.g. a thread or a job id) split the counter space, without overlap (if stream < 65536 with 4 dims).
+ * like Eye, it has any size and rank.
+ */
+template<class T, class D>
+struct Random
+{
+    using Tview = Random;
+    using Texec = Trand;
+
+    constexpr static const auto $rank = 0;
+
+    Random(const D& dist, u64 seed, u32 stream)
+        : dist_(dist), k0_(u32(seed)), k1_(u32(seed >> 32)), stream_(stream)
+    {}
+
+    /* the same numbers, with another stream */
+    Random stream(u32 id) const noexcept {
+        return { dist_, u64(k0_) | u64(k1_) << 32, id };
+    }
+
+    template<class I>
+    u32 size(I /*idx*/) const noexcept {
+        return 0;
+    }
+
+    template<class ...I>
+    T operator()(I ...ids) const noexcept {
+        static_assert(sizeof...(I) <= 4, "nms.math.Random: $rank should <= 4");
+
+        const u32 idx[] = { u32(ids)..., 0u, 0u, 0u };
+        u32 x[4];
+        block(idx[0] >> 2, idx[1], idx[2], idx[3], x);
+        return dist_.run(x, idx[0] & 3);
+    }
+
+    /* the 4 raw numbers of the block, which holds the items (4*i0 .. 4*i0+3, i1, i2, i3) */
+    __forceinline void block(u32 i0, u32 i1, u32 i2, u32 i3, u32(&x)[4]) const noexcept {
+        x[0] = i0;
+        x[1] = i1;
+        x[2] = i2;
+        x[3] = stream_ ^ (i3 << 16);
+        ns_random::philox(x, k0_, k1_);
+    }
+
+    const D& dist() const noexcept {
+        return dist_;
+    }
+
+protected:
+    D   dist_;
+    u32 k0_;
+    u32 k1_;
+    u32 stream_;
+};
+
+/* uniform random view in [lo, hi) */
+template<class T>
+auto randu(u64 seed, T lo = T(0), T hi = T(1), u32 stream = 0) {
+    return Random<T, Uniform<T>>({ lo, hi }, seed, stream);
+}
+
+/* normal random view */
+template<class T>
+auto randn(u64 seed, T mean = T(0), T sigma = T(1), u32 stream = 0) {
+    return Random<T, Normal<T>>({ mean, sigma }, seed, stream);
+}
+
+/* exponential random view */
+template<class T>
+auto rande(u64 seed, T lambda = T(1), u32 stream = 0) {
+    return Random<T, Exponential<T>>({ lambda }, seed, stream);
+}
+
+/*!
+ * random executor: a view is filled row by row, each philox block gives 4 items.
+ * (the item-wise path computes a block per item.)
+ */
+struct Trand
+{
+    template<class Tfunc, class T, u32 N, class U, class D>
+    void foreach(Tfunc func, View<T, N>& ret, const Random<U, D>& arg) {
+        static_assert(N <= 4, "nms.math.Trand: $rank should <= 4");
+
+        const auto& dist = arg.dist();
+        for (ViewCursor<T, N> c(ret, 1); !c.isEnd(); c.next()) {
+            const auto n   = c.count();
+            const auto s   = c.step();
+            const auto p   = c.data();
+            const auto idx = c.index();
+            const u32  i1  = N > 1 ? u32(idx[N > 1 ? 1 : 0]) : 0;
+            const u32  i2  = N > 2 ? u32(idx[N > 2 ? 2 : 0]) : 0;
+            const u32  i3  = N > 3 ? u32(idx[N > 3 ? 3 : 0]) : 0;
+
+            u32 x[4];
+            usize i = 0;
+            for (; i + 4 <= n; i += 4) {
+                arg.block(u32(i >> 2), i1, i2, i3, x);
+                func(p[(i + 0) * s], dist.run(x, 0));
+                func(p[(i + 1) * s], dist.run(x, 1));
+                func(p[(i + 2) * s], dist.run(x, 2));
+                func(p[(i + 3) * s], dist.run(x, 3));
+            }
+            if (i < n) {
+                arg.block(u32(i >> 2), i1, i2, i3, x);
+                for (u32 k = 0; i < n; ++i, ++k) {
+                    func(p[i * s], dist.run(x, k));
+                }
+            }
+        }
+    }
+
+    template<class Tfunc, class Tret, class ...Targs>
+    void foreach(Tfunc func, Tret& ret, const Targs& ...args) {
+        Texec{}.foreach(func, ret, args...);
+    }
+};
+
+inline Trand operator||(const Texec&, const Trand&) {
+    return {};
+}
+
+inline Trand operator||(const Trand&, const Texec&) {
+    return {};
+}
+
+inline Trand operator||(const Trand&, const Trand&) {
+    return {};
+}
+
+}
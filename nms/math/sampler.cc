@@ -0,0 +1,125 @@
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io/log.h>
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+nms_test(sampler) {
+    // img(x, y) = x + 10y: linear and cubic filters are exact inside
+    Array<f32, 2> img({ 7u, 5u });
+    img <<= lins(1.0f, 10.0f);
+
+    auto s = sampler(img, FilterMode::Linear);
+    test::assert_eq(s(3u, 2u), img(3, 2));
+    test::assert_eq(abs(s(2.8f, 2.2f) - 19.3f) < 1e-4f, true);
+
+    auto c = sampler(img, FilterMode::Cubic);
+    test::assert_eq(abs(c(3.3f, 2.1f) - 18.8f) < 1e-4f, true);
+    test::assert_eq(c(4u, 1u), img(4, 1));
+
+    auto p = sampler(img, FilterMode::Point);
+    test::assert_eq(p(2.9f, 1.2f), img(2, 1));
+
+    // border modes: texel -1 and 7 of the first row
+    auto clamp  = sampler(img, FilterMode::Point, BorderMode::Clamp);
+    auto wrap   = sampler(img, FilterMode::Point, BorderMode::Wrap);
+    auto mirror = sampler(img, FilterMode::Point, BorderMode::Mirror);
+    auto border = sampler(img, FilterMode::Point, BorderMode::Border, -1.0f);
+    test::assert_eq(clamp (-0.5f, 0.5f), img(0, 0));
+    test::assert_eq(wrap  (-0.5f, 0.5f), img(6, 0));
+    test::assert_eq(wrap  ( 7.5f, 0.5f), img(0, 0));
+    test::assert_eq(mirror(-0.5f, 0.5f), img(0, 0));
+    test::assert_eq(mirror( 7.5f, 0.5f), img(6, 0));
+    test::assert_eq(border( 7.5f, 0.5f), -1.0f);
+    test::assert_eq(border(0.0f / 0.0f, 0.5f), -1.0f);
+
+    // linear at the border: half of the border value
+    auto lb = sampler(img, FilterMode::Linear, BorderMode::Border, 0.0f);
+    test::assert_eq(lb(0.0f, 0.5f), img(0, 0) * 0.5f);
+
+    // integer texels: rounded
+    Array<u8, 1> u({ 2u });
+    u(0) = 10;
+    u(1) = 21;
+    auto su = sampler(u);
+    test::assert_eq(su(1.0f), u8(16));
+
+    // 3-d
+    Array<f64, 3> vol({ 6u, 5u, 4u });
+    vol <<= lins(1.0, 2.0, 3.0);
+    auto sv = sampler(vol, FilterMode::Cubic);
+    test::assert_eq(abs(sv(2.75, 2.5, 1.75) - (2.25 + 2 * 2.0 + 3 * 1.25)) < 1e-9, true);
+}
+
+nms_test(sampler_gather) {
+    Array<f32, 2> img({ 64u, 48u });
+    img <<= vsin(lins(0.1f, 0.07f));
+
+    // inside, outside, nan
+    static const u32 $count = 1001;
+    Array<f32, 2> xy({ 2u, $count });
+    auto seed = 5u;
+    for (u32 k = 0; k < $count; ++k) {
+        seed = seed * 1103515245u + 12345u;
+        xy(0, k) = f32((seed >> 8) % 7000) * 0.01f - 2.0f;
+        seed = seed * 1103515245u + 12345u;
+        xy(1, k) = f32((seed >> 8) % 5200) * 0.01f - 2.0f;
+    }
+    xy(0, 10) = 0.0f / 0.0f;
+
+    auto errs = 0u;
+    const BorderMode modes[] = { BorderMode::Wrap, BorderMode::Clamp, BorderMode::Mirror, BorderMode::Border };
+    for (auto mode : modes) {
+        auto s = sampler(img, FilterMode::Linear, mode, 2.0f);
+        Array<f32, 1> out({ $count });
+        s.gather(out, xy);
+
+        for (u32 k = 0; k < $count; ++k) {
+            const f32 pos[] = { xy(0, k), xy(1, k) };
+            errs += abs(out(k) - s.sample(pos)) <= 1e-5f ? 0 : 1;
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // to u8, cubic
+    Array<u8, 1> q({ $count });
+    sampler(img, FilterMode::Cubic).gather(q, xy);
+}
+
+nms_test(sampler_bench) {
+    static const u32 $count = 1024 * 1024;
+
+    Array<f32, 2> img({ 1024u, 1024u });
+    Array<f32, 2> xy({ 2u, $count });
+    Array<f32, 1> a({ $count });
+    Array<f32, 1> b({ $count });
+    img <<= lins(1.0f, 2.0f);
+
+    // a rotation
+    for (u32 k = 0; k < $count; ++k) {
+        const auto x = f32(k % 1024);
+        const auto y = f32(k / 1024);
+        xy(0, k) = 0.9f * x - 0.1f * y + 80.0f;
+        xy(1, k) = 0.1f * x + 0.9f * y + 20.0f;
+    }
+
+    auto s = sampler(img);
+    const auto t0 = clock();
+    for (u32 k = 0; k < $count; ++k) {
+        a(k) = s(xy(0, k), xy(1, k));
+    }
+    const auto t1 = clock();
+    s.gather(b, xy);
+    const auto t2 = clock();
+
+    test::assert_eq(abs(a(12345) - b(12345)) < 1e-3f, true);
+    io::log::info("nms.math.sampler: {} points, linear 2-d, one by one {:.3f} ms, gather {:.3f} ms",
+        $count, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <nms/core.h>
+#include <nms/math/view.h>
+#include <nms/math/stencil.h>
+#include <nms/math/convert.h>
+
+namespace nms::math
+{
+
+/* filter mode of Sampler, Point and Linear are the same values as cuda::TexFilterMode */
+enum class FilterMode
+{
+    Point   = 0,    // nearest texel
+    Linear  = 1,    // 2 taps per dim
+    Cubic   = 2,    // 4 taps per dim, Catmull-Rom
+};
+
+namespace ns_sampler
+{
+
+/* the taps of a dim: indices (-1: the border value), and weights */
+template<class Tc>
+struct Taps
+{
+    u32 count;
+    i64 idx[4];
+    Tc  w[4];
+};
+
+/* texel centers are at i + 0.5, as cuda textures */
+template<class Tc>
+void taps(Taps<Tc>& t, Tc x, i64 n, FilterMode filter, BorderMode border) {
+    if (!(x == x)) {
+        t.count  = 1;
+        t.idx[0] = -1;
+        t.w[0]   = Tc(1);
+        return;
+    }
+
+    if (filter == FilterMode::Point) {
+        t.count  = 1;
+        t.idx[0] = borderIndex(i64(::floor(x)), n, border);
+        t.w[0]   = Tc(1);
+        return;
+    }
+
+    const auto xb = x - Tc(0.5);
+    const auto fi = ::floor(xb);
+    const auto a  = xb - fi;
+    const auto i  = i64(fi);
+
+    if (filter == FilterMode::Linear) {
+        t.count  = 2;
+        t.idx[0] = borderIndex(i + 0, n, border);
+        t.idx[1] = borderIndex(i + 1, n, border);
+        t.w[0]   = Tc(1) - a;
+        t.w[1]   = a;
+        return;
+    }
+
+    const auto a2 = a * a;
+    const auto a3 = a2 * a;
+    t.count  = 4;
+    t.idx[0] = borderIndex(i - 1, n, border);
+    t.idx[1] = borderIndex(i + 0, n, border);
+    t.idx[2] = borderIndex(i + 1, n, border);
+    t.idx[3] = borderIndex(i + 2, n, border);
+    t.w[0]   = Tc(-0.5) * a3 + a2 - Tc(0.5) * a;
+    t.w[1]   = Tc(+1.5) * a3 - Tc(2.5) * a2 + Tc(1);
+    t.w[2]   = Tc(-1.5) * a3 + Tc(2.0) * a2 + Tc(0.5) * a;
+    t.w[3]   = Tc(+0.5) * a3 - Tc(0.5) * a2;
+}
+
+}
+
+/*!
+ * CPU texture sampler over a View, the counterpart of cuda::TexView.
+ * coordinates are not normalized, and texel i is centered at i + 0.5 (as cuda textures):
+ *   s(x, y)            sample at float coordinates
+ *   s(i, j)            integer coordinates: the texel (i, j)
+ * out-of-range taps are mapped by BorderMode, nan coordinates give the border value.
+ * samples are computed in f32 (f64 for f64), and rounded and clamped for integer texels.
+ */
+template<class T, u32 N>
+struct Sampler
+{
+    using Tc = Tcond<$is<f64, T>, f64, f32>;
+
+    constexpr static const auto $rank = N;
+
+    Sampler(const View<T, N>& view, FilterMode filter = FilterMode::Linear, BorderMode border = BorderMode::Clamp, T border_value = T(0))
+        : view_(view), filter_(filter), border_(border), value_(border_value)
+    {}
+
+    FilterMode filter() const noexcept {
+        return filter_;
+    }
+
+    BorderMode border() const noexcept {
+        return border_;
+    }
+
+    template<class ...X>
+    T operator()(X ...x) const {
+        static_assert(sizeof...(X) == N, "nms.math.Sampler: $rank not match");
+        const Tc pos[] = { ($is<$int, X> ? Tc(x) + Tc(0.5) : Tc(x))... };
+        return ns_convert::cast<RoundMode::Nearest, T>(sample(pos));
+    }
+
+    /* sample at `pos`, not rounded */
+    Tc sample(const Tc(&pos)[N]) const {
+        ns_sampler::Taps<Tc> t[N];
+        for (u32 d = 0; d < N; ++d) {
+            ns_sampler::taps(t[d], pos[d], i64(view_.size(d)), filter_, border_);
+        }
+
+        // all combinations of the taps: an odometer over dims
+        u32 k[N] = {};
+        Tc  acc  = Tc(0);
+        for (;;) {
+            Tc    w   = Tc(1);
+            i64   off = 0;
+            bool  out = false;
+            for (u32 d = 0; d < N; ++d) {
+                const auto i = t[d].idx[k[d]];
+                w   *= t[d].w[k[d]];
+                out |= i < 0;
+                off += i * i64(view_.stride(d));
+            }
+            acc += w * Tc(out ? value_ : view_.data()[off]);
+
+            u32 d = 0;
+            for (; d < N; ++d) {
+                if (++k[d] < t[d].count) {
+                    break;
+                }
+                k[d] = 0;
+            }
+            if (d == N) {
+                break;
+            }
+        }
+        return acc;
+    }
+
+    /*!
+     * batched sampling: out(k) = sample at (coords(0, k), .. coords(N-1, k)).
+     * 2-d f32 textures with linear filter are sampled 4 points at a time with sse2,
+     * when the 4 footprints are inside the view.
+     */
+    template<class U>
+    void gather(View<U, 1> out, const View<f32, 2>& coords) const {
+        if (coords.size(0) != N || coords.size(1) != out.size(0)) {
+            NMS_THROW(EBadSize{});
+        }
+
+        const auto n = out.size(0);
+        usize k = 0;
+#ifdef NMS_MATH_SSE2
+        if constexpr(N == 2 && $is<f32, T> && $is<f32, U>) {
+            if (filter_ == FilterMode::Linear && coords.stride(0) == 1 && coords.stride(1) == 2 && out.stride(0) == 1) {
+                k = gatherLinear2(out.data(), coords.data(), n);
+            }
+        }
+#endif
+        for (; k < n; ++k) {
+            Tc pos[N];
+            for (u32 d = 0; d < N; ++d) {
+                pos[d] = Tc(coords(d, k));
+            }
+            out(k) = ns_convert::cast<RoundMode::Nearest, U>(sample(pos));
+        }
+    }
+
+protected:
+    View<T, N>  view_;
+    FilterMode  filter_;
+    BorderMode  border_;
+    T           value_;
+
+#ifdef NMS_MATH_SSE2
+    /* 4 points per loop: weights in registers, texels fetched by lane (no gather in sse2) */
+    usize gatherLinear2(f32* out, const f32* xy, usize n) const {
+        const auto w  = i32(view_.size(0));
+        const auto h  = i32(view_.size(1));
+        const auto sx = i32(view_.stride(0));
+        const auto sy = i32(view_.stride(1));
+        const auto p  = view_.data();
+
+        const auto half = _mm_set1_ps(0.5f);
+        const auto lo   = _mm_set1_epi32(-1);
+        const auto hx   = _mm_set1_epi32(w - 1);
+        const auto hy   = _mm_set1_epi32(h - 1);
+
+        usize k = 0;
+        for (; k + 4 <= n; k += 4) {
+            const auto v0 = _mm_loadu_ps(xy + 2 * k + 0);
+            const auto v1 = _mm_loadu_ps(xy + 2 * k + 4);
+            const auto x  = _mm_sub_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)), half);
+            const auto y  = _mm_sub_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)), half);
+
+            // floor: truncate, then step down the negative non-integers
+            auto ix = _mm_cvttps_epi32(x);
+            auto iy = _mm_cvttps_epi32(y);
+            ix = _mm_add_epi32(ix, _mm_castps_si128(_mm_cmplt_ps(x, _mm_cvtepi32_ps(ix))));
+            iy = _mm_add_epi32(iy, _mm_castps_si128(_mm_cmplt_ps(y, _mm_cvtepi32_ps(iy))));
+            const auto ax = _mm_sub_ps(x, _mm_cvtepi32_ps(ix));
+            const auto ay = _mm_sub_ps(y, _mm_cvtepi32_ps(iy));
+
+            // 2x2 footprints inside: 0 <= i, i + 1 < size (nan fails the compare of ax/ay)
+            const auto in = _mm_and_si128(
+                _mm_and_si128(_mm_cmpgt_epi32(ix, lo), _mm_cmplt_epi32(ix, hx)),
+                _mm_and_si128(_mm_cmpgt_epi32(iy, lo), _mm_cmplt_epi32(iy, hy)));
+            const auto ok = _mm_castps_si128(_mm_and_ps(_mm_cmpord_ps(ax, ax), _mm_cmpord_ps(ay, ay)));
+            if (_mm_movemask_epi8(_mm_and_si128(in, ok)) != 0xFFFF) {
+                for (u32 l = 0; l < 4; ++l) {
+                    const f32 pos[] = { xy[2 * (k + l) + 0], xy[2 * (k + l) + 1] };
+                    out[k + l] = sample(pos);
+                }
+                continue;
+            }
+
+            alignas(16) i32 bx[4], by[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(bx), ix);
+            _mm_store_si128(reinterpret_cast<__m128i*>(by), iy);
+
+            alignas(16) f32 t00[4], t10[4], t01[4], t11[4];
+            for (u32 l = 0; l < 4; ++l) {
+                const auto q = p + bx[l] * sx + by[l] * sy;
+                t00[l] = q[0];
+                t10[l] = q[sx];
+                t01[l] = q[sy];
+                t11[l] = q[sx + sy];
+            }
+
+            const auto r0 = _mm_add_ps(_mm_load_ps(t00), _mm_mul_ps(ax, _mm_sub_ps(_mm_load_ps(t10), _mm_load_ps(t00))));
+            const auto r1 = _mm_add_ps(_mm_load_ps(t01), _mm_mul_ps(ax, _mm_sub_ps(_mm_load_ps(t11), _mm_load_ps(t01))));
+            _mm_storeu_ps(out + k, _mm_add_ps(r0, _mm_mul_ps(ay, _mm_sub_ps(r1, r0))));
+        }
+        return k;
+    }
+#endif
+};
+
+/* make a Sampler of `view` */
+template<class T, u32 N>
+Sampler<T, N> sampler(const View<T, N>& view, FilterMode filter = FilterMode::Linear, BorderMode border = BorderMode::Clamp, T border_value = T(0)) {
+    return { view, filter, border, border_value };
+}
+
+}
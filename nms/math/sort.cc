@@ -0,0 +1,179 @@
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io/log.h>
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+namespace
+{
+u32 rand32(u32& seed) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+template<class T, u32 N>
+u32 unsorted(const View<T, N>& view) {
+    auto errs = 0u;
+    auto prev = T(0);
+    auto idx  = 0u;
+    for (auto c = view.cursor(); !c.isEnd(); c.next()) {
+        for (usize i = 0; i < c.count(); ++i, ++idx) {
+            const auto v = c.data()[i * c.step()];
+            errs += idx > 0 && v < prev ? 1 : 0;
+            prev  = v;
+        }
+    }
+    return errs;
+}
+}
+
+nms_test(sort) {
+    auto seed = 1u;
+
+    // float: negative, -0.0
+    Array<f32, 1> a({ 1000u });
+    for (u32 i = 0; i < 1000; ++i) {
+        a(i) = f32(i32(rand32(seed) % 2001) - 1000) * 0.5f;
+    }
+    a(7) = -0.0f;
+    auto sum0 = 0.0;
+    for (u32 i = 0; i < 1000; ++i) {
+        sum0 += a(i);
+    }
+    sort(a);
+    auto sum1 = 0.0;
+    for (u32 i = 0; i < 1000; ++i) {
+        sum1 += a(i);
+    }
+    test::assert_eq(unsorted(a), 0u);
+    test::assert_eq(sum0, sum1);
+
+    // signed, 64 bit
+    Array<i64, 1> b({ 500u });
+    for (u32 i = 0; i < 500; ++i) {
+        b(i) = (i64(rand32(seed)) - (1 << 23)) * 1000003;
+    }
+    sort(b);
+    test::assert_eq(unsorted(b), 0u);
+
+    // i8, strided view
+    Array<i8, 2> c({ 40u, 30u });
+    for (u32 j = 0; j < 30; ++j) {
+        for (u32 i = 0; i < 40; ++i) {
+            c(i, j) = i8(rand32(seed));
+        }
+    }
+    auto ct = c.permute({ 1u, 0u });
+    sort(ct);
+    test::assert_eq(unsorted(ct), 0u);
+
+    // comparison sort: descending
+    Array<u32, 1> d({ 300u });
+    for (u32 i = 0; i < 300; ++i) {
+        d(i) = rand32(seed) % 100;
+    }
+    sort(d, [](u32 x, u32 y) { return x > y; });
+    auto errs = 0u;
+    for (u32 i = 1; i < 300; ++i) {
+        errs += d(i - 1) >= d(i) ? 0 : 1;
+    }
+    test::assert_eq(errs, 0u);
+}
+
+nms_test(sort_select) {
+    auto seed = 7u;
+
+    Array<f32, 2> a({ 33u, 31u });
+    Array<f32, 1> s({ 33u * 31u });
+    for (u32 i = 0; i < a.count(); ++i) {
+        a.data()[i] = f32(rand32(seed) % 500);
+        s(i)        = a.data()[i];
+    }
+    sort(s);
+
+    // argsort: stable
+    Array<usize, 1> idx({ a.count() });
+    argsort(a, idx);
+    auto errs = 0u;
+    for (u32 i = 0; i < a.count(); ++i) {
+        errs += a.data()[idx(i)] == s(i) ? 0 : 1;
+        errs += i == 0 || s(i - 1) != s(i) || idx(i - 1) < idx(i) ? 0 : 1;
+    }
+    test::assert_eq(errs, 0u);
+
+    // percentile, median
+    const auto n = a.count();
+    test::assert_eq(percentile(a, 0.0), f64(s(0)));
+    test::assert_eq(percentile(a, 1.0), f64(s(n - 1)));
+    test::assert_eq(median(a), f64(s((n - 1) / 2)));
+    const auto r = 0.9 * (n - 1);
+    const auto k = usize(r);
+    test::assert_eq(percentile(a, 0.9), f64(s(k)) + (f64(s(k + 1)) - f64(s(k))) * (r - f64(k)));
+
+    // topk
+    Array<f32, 1> top({ 10u });
+    topk(a, top);
+    for (u32 i = 0; i < 10; ++i) {
+        errs += top(i) == s(n - 1 - i) ? 0 : 1;
+    }
+
+    // selectN
+    Array<f32, 2> b({ 33u, 31u });
+    b <<= a;
+    test::assert_eq(selectN(b, 100), s(100));
+    for (u32 i = 0; i < n; ++i) {
+        errs += i < 100 && b.data()[i] > s(100) ? 1 : 0;
+        errs += i > 100 && b.data()[i] < s(100) ? 1 : 0;
+    }
+    test::assert_eq(errs, 0u);
+
+    // histogram
+    Array<u32, 1> bins({ 5u });
+    bins <<= 0u;
+    histogram(a, bins, 0.0, 499.0);
+    auto total = 0u;
+    for (u32 i = 0; i < 5; ++i) {
+        total += bins(i);
+    }
+    test::assert_eq(total, n);
+
+    auto cnt0 = 0u;
+    for (u32 i = 0; i < n; ++i) {
+        cnt0 += s(i) < 499.0f / 5 ? 1 : 0;
+    }
+    test::assert_eq(bins(0), cnt0);
+}
+
+nms_test(sort_bench) {
+    static const u32 $count = 1024 * 1024;
+
+    Array<f32, 1> a({ $count });
+    Array<f32, 1> b({ $count });
+    auto seed = 3u;
+    for (u32 i = 0; i < $count; ++i) {
+        a(i) = f32(rand32(seed)) * 1e-3f - 4000.0f;
+    }
+    b <<= a;
+
+    const auto t0 = clock();
+    sort(a);
+    const auto t1 = clock();
+    sort(b, [](f32 x, f32 y) { return x < y; });
+    const auto t2 = clock();
+    const auto p  = percentile(b, 0.99);
+    const auto t3 = clock();
+
+    const auto r = 0.99 * ($count - 1);
+    const auto k = usize(r);
+    test::assert_eq(unsorted(a), 0u);
+    test::assert_eq(p, f64(b(k)) + (f64(b(k + 1)) - f64(b(k))) * (r - f64(k)));
+    io::log::info("nms.math.sort: {} f32, radix {:.3f} ms, introsort {:.3f} ms, percentile {:.3f} ms",
+        $count, (t1 - t0) * 1000, (t2 - t1) * 1000, (t3 - t2) * 1000);
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,497 @@
+#pragma once
+
+#include <nms/core.h>
+
+namespace nms::math
+{
+
+namespace ns_sort
+{
+
+/* the count of items below which insertion sort is used */
+constexpr static const usize $small = 32;
+
+/* copy all items of `view` to `buf`, in linear (dim 0 first) order */
+template<class T, u32 N, class U>
+void gather(const View<T, N>& view, U* buf) {
+    for (auto c = view.cursor(); !c.isEnd(); c.next()) {
+        const auto n = c.count();
+        const auto s = c.step();
+        const auto p = c.data();
+        for (usize i = 0; i < n; ++i) {
+            *buf++ = p[i * s];
+        }
+    }
+}
+
+/* copy `buf` back to all items of `view` */
+template<class T, u32 N>
+void scatter(View<T, N>& view, const T* buf) {
+    for (auto c = view.cursor(); !c.isEnd(); c.next()) {
+        const auto n = c.count();
+        const auto s = c.step();
+        const auto p = c.data();
+        for (usize i = 0; i < n; ++i) {
+            p[i * s] = *buf++;
+        }
+    }
+}
+
+/* radix key: an unsigned integer with the same order as T */
+template<class T>
+__forceinline auto radixKey(T x) noexcept {
+    using U = Tcond<sizeof(T) <= 4, u32, u64>;
+    constexpr static const u32 $bits = u32(sizeof(T) * 8);
+    constexpr static const U   $sign = U(1) << ($bits - 1);
+
+    if constexpr($is<$float, T>) {
+        U u;
+        mcpy(reinterpret_cast<u8*>(&u), reinterpret_cast<const u8*>(&x), sizeof(T));
+        return (u & $sign) ? U(~u) : U(u | $sign);
+    }
+    else if constexpr($bits < sizeof(U) * 8) {
+        const auto u = U(x) & ((U(1) << $bits) - 1);
+        return $is<$sint, T> ? U(u ^ $sign) : u;
+    }
+    else {
+        return $is<$sint, T> ? U(U(x) ^ $sign) : U(x);
+    }
+}
+
+/*!
+ * LSD radix sort, 8 bits a pass, stable.
+ * the histograms of all passes are counted in one read, and the passes where all keys share a digit are skipped.
+ * `idx` (may be nullptr) is moved with the items.
+ */
+template<class T>
+void radixSort(T* data, T* tmp, usize* idx, usize* itmp, usize n) {
+    constexpr static const u32 $passes = u32(sizeof(T));
+
+    const auto hist = mnew<usize>(256 * $passes);
+    for (usize i = 0; i < 256 * $passes; ++i) {
+        hist[i] = 0;
+    }
+    for (usize i = 0; i < n; ++i) {
+        const auto key = radixKey(data[i]);
+        for (u32 p = 0; p < $passes; ++p) {
+            ++hist[p * 256 + ((key >> (p * 8)) & 0xFF)];
+        }
+    }
+
+    auto src  = data;
+    auto dst  = tmp;
+    auto isrc = idx;
+    auto idst = itmp;
+    for (u32 p = 0; p < $passes; ++p) {
+        const auto cnt = hist + p * 256;
+        if (cnt[(radixKey(data[0]) >> (p * 8)) & 0xFF] == n) {
+            continue;
+        }
+
+        // counts -> offsets
+        usize sum = 0;
+        for (u32 b = 0; b < 256; ++b) {
+            const auto c = cnt[b];
+            cnt[b] = sum;
+            sum   += c;
+        }
+
+        for (usize i = 0; i < n; ++i) {
+            const auto pos = cnt[(radixKey(src[i]) >> (p * 8)) & 0xFF]++;
+            dst[pos] = src[i];
+            if (isrc != nullptr) {
+                idst[pos] = isrc[i];
+            }
+        }
+        swap(src, dst);
+        swap(isrc, idst);
+    }
+
+    if (src != data) {
+        mcpy(data, src, n);
+        if (idx != nullptr) {
+            mcpy(idx, isrc, n);
+        }
+    }
+    mdel(hist);
+}
+
+template<class T, class Tless>
+void insertSort(T* a, usize n, Tless& less) {
+    for (usize i = 1; i < n; ++i) {
+        auto   v = move(a[i]);
+        auto   j = i;
+        for (; j > 0 && less(v, a[j - 1]); --j) {
+            a[j] = move(a[j - 1]);
+        }
+        a[j] = move(v);
+    }
+}
+
+template<class T, class Tless>
+void heapDown(T* a, usize root, usize n, Tless& less) {
+    for (;;) {
+        auto child = root * 2 + 1;
+        if (child >= n) {
+            return;
+        }
+        if (child + 1 < n && less(a[child], a[child + 1])) {
+            ++child;
+        }
+        if (!less(a[root], a[child])) {
+            return;
+        }
+        swap(a[root], a[child]);
+        root = child;
+    }
+}
+
+template<class T, class Tless>
+void heapSort(T* a, usize n, Tless& less) {
+    for (usize i = n / 2; i-- > 0; ) {
+        heapDown(a, i, n, less);
+    }
+    for (usize i = n; i-- > 1; ) {
+        swap(a[0], a[i]);
+        heapDown(a, 0, i, less);
+    }
+}
+
+/* partition around the median of 3, returns the pivot position */
+template<class T, class Tless>
+usize partition(T* a, usize n, Tless& less) {
+    const auto m = n / 2;
+    if (less(a[m], a[0]))     swap(a[m], a[0]);
+    if (less(a[n - 1], a[0])) swap(a[n - 1], a[0]);
+    if (less(a[n - 1], a[m])) swap(a[n - 1], a[m]);
+
+    // a[0] <= pivot <= a[n-1]: sentinels
+    swap(a[m], a[n - 2]);
+    const auto& pivot = a[n - 2];
+    usize i = 0;
+    usize j = n - 2;
+    for (;;) {
+        while (less(a[++i], pivot)) {}
+        while (less(pivot, a[--j])) {}
+        if (i >= j) {
+            break;
+        }
+        swap(a[i], a[j]);
+    }
+    swap(a[i], a[n - 2]);
+    return i;
+}
+
+/* depth limit of introsort */
+inline u32 depthOf(usize n) {
+    auto depth = u32(0);
+    for (; n > 1; n >>= 1) {
+        depth += 2;
+    }
+    return depth;
+}
+
+/* introsort: quick sort, heap sort if too deep */
+template<class T, class Tless>
+void introSort(T* a, usize n, Tless& less, u32 depth) {
+    while (n > $small) {
+        if (depth-- == 0) {
+            heapSort(a, n, less);
+            return;
+        }
+        const auto p = partition(a, n, less);
+
+        // recurse into the smaller part
+        if (p < n - p) {
+            introSort(a, p, less, depth);
+            a += p + 1;
+            n -= p + 1;
+        }
+        else {
+            introSort(a + p + 1, n - p - 1, less, depth);
+            n = p;
+        }
+    }
+    insertSort(a, n, less);
+}
+
+/* quick select: a[k] is the k-th item, a[0,k) <= a[k] <= a(k,n). O(n) on average, O(n*log(n)) at most */
+template<class T, class Tless>
+void select(T* a, usize n, usize k, Tless& less) {
+    auto depth = depthOf(n);
+    while (n > $small) {
+        if (depth-- == 0) {
+            heapSort(a, n, less);
+            return;
+        }
+        const auto p = partition(a, n, less);
+        if (k == p) {
+            return;
+        }
+        if (k < p) {
+            n = p;
+        }
+        else {
+            a += p + 1;
+            n -= p + 1;
+            k -= p + 1;
+        }
+    }
+    insertSort(a, n, less);
+}
+
+struct Less
+{
+    template<class T>
+    __forceinline bool operator()(const T& a, const T& b) const noexcept {
+        return a < b;
+    }
+};
+
+template<class T>
+constexpr bool isRadix() {
+    return $is<$number, T> && !$is<bool, T>;
+}
+
+}
+
+/*!
+ * sort all items of `view` with `less`, in linear (dim 0 first) order.
+ * introsort, not stable.
+ * a view which is not normal is sorted in a buffer: T should be trivially copyable, or EBadType is thrown.
+ */
+template<class T, u32 N, class Tless>
+void sort(View<T, N> view, Tless less) {
+    const auto n = view.count();
+    if (n < 2) {
+        return;
+    }
+
+    if (view.isNormal()) {
+        ns_sort::introSort(view.data(), n, less, ns_sort::depthOf(n));
+        return;
+    }
+
+    if (!$is_trivially_copyable<T>) {
+        NMS_THROW(EBadType{});
+    }
+    const auto buf = mnew<T>(n);
+    ns_sort::gather(view, buf);
+    ns_sort::introSort(buf, n, less, ns_sort::depthOf(n));
+    ns_sort::scatter(view, buf);
+    mdel(buf);
+}
+
+/*!
+ * sort all items of `view` ascending, in linear (dim 0 first) order.
+ * numbers are sorted by radix sort: O(n), stable, -0.0 before +0.0, NaN at the ends.
+ */
+template<class T, u32 N>
+void sort(View<T, N> view) {
+    if constexpr(!ns_sort::isRadix<T>()) {
+        sort(view, ns_sort::Less{});
+    }
+    else {
+        const auto n = view.count();
+        if (n <= ns_sort::$small) {
+            sort(view, ns_sort::Less{});
+            return;
+        }
+
+        const auto normal = view.isNormal();
+        const auto buf = mnew<T>(normal ? n : 2 * n);
+        const auto dat = normal ? view.data() : buf + n;
+        if (!normal) {
+            ns_sort::gather(view, dat);
+        }
+        ns_sort::radixSort(dat, buf, static_cast<usize*>(nullptr), static_cast<usize*>(nullptr), n);
+        if (!normal) {
+            ns_sort::scatter(view, dat);
+        }
+        mdel(buf);
+    }
+}
+
+/*!
+ * stable argsort: `idx[i]` is the linear index of the i-th smallest item.
+ * `idx` should have view.count() items.
+ */
+template<class T, u32 N>
+void argsort(const View<T, N>& view, View<usize, 1> idx) {
+    using U = Tmutable<T>;
+    static_assert(ns_sort::isRadix<U>(), "nms.math.argsort: T should be number");
+
+    const auto n = view.count();
+    if (idx.count() != n) {
+        NMS_THROW(EBadSize{});
+    }
+    if (n == 0) {
+        return;
+    }
+
+    const auto dat = mnew<U>(2 * n);
+    const auto itm = mnew<usize>(2 * n);
+    ns_sort::gather(view, dat);
+    for (usize i = 0; i < n; ++i) {
+        itm[i] = i;
+    }
+    ns_sort::radixSort(dat, dat + n, itm, itm + n, n);
+    ns_sort::scatter(idx, itm);
+    mdel(dat);
+    mdel(itm);
+}
+
+/*!
+ * the k-th smallest item of `view` (k = 0 is the min). O(n).
+ * `view` is partially reordered: the smaller items before k, the larger after.
+ */
+template<class T, u32 N>
+T selectN(View<T, N> view, usize k) {
+    const auto n = view.count();
+    if (k >= n) {
+        NMS_THROW(EOutOfRange{});
+    }
+
+    ns_sort::Less less;
+    if (view.isNormal()) {
+        ns_sort::select(view.data(), n, k, less);
+        return view.data()[k];
+    }
+
+    if (!$is_trivially_copyable<T>) {
+        NMS_THROW(EBadType{});
+    }
+    const auto buf = mnew<T>(n);
+    ns_sort::gather(view, buf);
+    ns_sort::select(buf, n, k, less);
+    const auto ret = buf[k];
+    ns_sort::scatter(view, buf);
+    mdel(buf);
+    return ret;
+}
+
+/*!
+ * percentile `p` in [0, 1] of all items, linear interpolated between the closest ranks. O(n).
+ * `view` is not changed: the items are copied to a buffer.
+ */
+template<class T, u32 N>
+f64 percentile(const View<T, N>& view, f64 p) {
+    using U = Tmutable<T>;
+    static_assert($is_trivially_copyable<U>, "nms.math.percentile: T should be trivially copyable");
+
+    const auto n = view.count();
+    if (n == 0) {
+        NMS_THROW(EBadSize{});
+    }
+
+    p = p < 0 ? 0 : p > 1 ? 1 : p;
+    const auto rank = p * f64(n - 1);
+    const auto k    = usize(rank);
+    const auto frac = rank - f64(k);
+
+    const auto buf = mnew<U>(n);
+    ns_sort::gather(view, buf);
+
+    ns_sort::Less less;
+    ns_sort::select(buf, n, k, less);
+    auto lo = f64(buf[k]);
+    auto hi = lo;
+    if (frac > 0 && k + 1 < n) {
+        // the next rank: the min of the right part
+        auto v = buf[k + 1];
+        for (usize i = k + 2; i < n; ++i) {
+            v = buf[i] < v ? buf[i] : v;
+        }
+        hi = f64(v);
+    }
+    mdel(buf);
+    return lo + (hi - lo) * frac;
+}
+
+/* median of all items, see percentile */
+template<class T, u32 N>
+f64 median(const View<T, N>& view) {
+    return percentile(view, 0.5);
+}
+
+/*!
+ * the largest out.count() items of `view`, descending. O(n + k*log(k)).
+ */
+template<class T, u32 N, class U>
+void topk(const View<T, N>& view, View<U, 1> out) {
+    static_assert($is_trivially_copyable<U>, "nms.math.topk: T should be trivially copyable");
+
+    const auto n = view.count();
+    const auto k = out.count();
+    if (k > n) {
+        NMS_THROW(EBadSize{});
+    }
+    if (k == 0) {
+        return;
+    }
+
+    const auto buf = mnew<U>(n);
+    ns_sort::gather(view, buf);
+
+    auto greater = [](const U& a, const U& b) { return b < a; };
+    ns_sort::select(buf, n, k - 1, greater);
+    ns_sort::introSort(buf, k, greater, ns_sort::depthOf(k));
+    ns_sort::scatter(out, buf);
+    mdel(buf);
+}
+
+/*!
+ * histogram of all items in [lo, hi], with bins.count() uniform bins: bins[i] += count.
+ * the items out of [lo, hi] (and NaN) are ignored, hi is in the last bin.
+ * 4 sub-histograms are counted in turn, so the increments of equal items do not wait for each other.
+ */
+template<class T, u32 N, class U>
+void histogram(const View<T, N>& view, View<U, 1> bins, f64 lo, f64 hi) {
+    const auto m = bins.count();
+    if (m == 0 || !(hi > lo)) {
+        NMS_THROW(EBadSize{});
+    }
+
+    const auto scale = f64(m) / (hi - lo);
+    const auto sub   = mnew<u32>(4 * m);
+    for (usize i = 0; i < 4 * m; ++i) {
+        sub[i] = 0;
+    }
+
+    auto bin = [=](f64 x) -> usize {
+        if (!(x >= lo && x <= hi)) {
+            return 4 * m;       // dropped
+        }
+        const auto b = usize((x - lo) * scale);
+        return b < m ? b : m - 1;
+    };
+
+    for (auto c = view.cursor(); !c.isEnd(); c.next()) {
+        const auto n = c.count();
+        const auto s = c.step();
+        const auto p = c.data();
+
+        usize i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const auto b0 = bin(f64(p[(i + 0) * s]));
+            const auto b1 = bin(f64(p[(i + 1) * s]));
+            const auto b2 = bin(f64(p[(i + 2) * s]));
+            const auto b3 = bin(f64(p[(i + 3) * s]));
+            if (b0 < m) ++sub[0 * m + b0];
+            if (b1 < m) ++sub[1 * m + b1];
+            if (b2 < m) ++sub[2 * m + b2];
+            if (b3 < m) ++sub[3 * m + b3];
+        }
+        for (; i < n; ++i) {
+            const auto b = bin(f64(p[i * s]));
+            if (b < m) ++sub[b];
+        }
+    }
+
+    for (usize i = 0; i < m; ++i) {
+        bins(i) += U(sub[i] + sub[m + i] + sub[2 * m + i] + sub[3 * m + i]);
+    }
+    mdel(sub);
+}
+
+}
@@ -0,0 +1,124 @@
+#include <nms/test.h>
+#include <nms/math.h>
+#include <nms/io/log.h>
+
+namespace nms::math
+{
+
+#pragma region unittest
+
+/* reference: direct loops with borderIndex */
+static f32 stencil_ref(const View<f32, 2>& src, const View<f32, 2>& kern, i64 x, i64 y, BorderMode mode, f32 border) {
+    const auto rx = i64(kern.size(0) / 2);
+    const auto ry = i64(kern.size(1) / 2);
+
+    auto sum = 0.0f;
+    for (i64 j = 0; j < i64(kern.size(1)); ++j) {
+        for (i64 i = 0; i < i64(kern.size(0)); ++i) {
+            const auto sx = borderIndex(x + i - rx, i64(src.size(0)), mode);
+            const auto sy = borderIndex(y + j - ry, i64(src.size(1)), mode);
+            const auto v  = sx < 0 || sy < 0 ? border : src(u32(sx), u32(sy));
+            sum += kern(u32(i), u32(j)) * v;
+        }
+    }
+    return sum;
+}
+
+nms_test(stencil) {
+    test::assert_eq(borderIndex(-1, 4, BorderMode::Wrap),   3);
+    test::assert_eq(borderIndex(-1, 4, BorderMode::Clamp),  0);
+    test::assert_eq(borderIndex(-1, 4, BorderMode::Mirror), 0);
+    test::assert_eq(borderIndex( 5, 4, BorderMode::Mirror), 2);
+    test::assert_eq(borderIndex( 4, 4, BorderMode::Border), -1);
+
+    // sobel: separable
+    f32 sobel_dat[] = { -1, 0, 1, -2, 0, 2, -1, 0, 1 };
+    const View<f32, 2> sobel(sobel_dat, { 3u, 3u });
+    test::assert_eq(isSeparable(sobel), true);
+
+    // random: not separable
+    f32 rand_dat[] = { 1, 2, 0, 0, 1, 3, 2, 0, 1, 1, 0, 2 };
+    const View<f32, 2> rand(rand_dat, { 4u, 3u });
+    test::assert_eq(isSeparable(rand), false);
+
+    Array<f32, 2> src({ 23u, 17u });
+    Array<f32, 2> dst({ 23u, 17u });
+    src <<= lins(0.5f, 0.25f);
+    src(3, 4)  = 10.0f;
+
+    const BorderMode modes[] = { BorderMode::Wrap, BorderMode::Clamp, BorderMode::Mirror, BorderMode::Border };
+    const View<f32, 2>* kerns[] = { &sobel, &rand };
+    auto errs = 0u;
+    for (auto mode : modes) {
+        for (auto kern : kerns) {
+            filter(dst, src, *kern, mode, 2.0f);
+            for (u32 y = 0; y < 17; ++y) {
+                for (u32 x = 0; x < 23; ++x) {
+                    const auto ref = stencil_ref(src, *kern, x, y, mode, 2.0f);
+                    const auto err = dst(x, y) - ref;
+                    errs += (err < 0 ? -err : err) < 1e-3f ? 0 : 1;
+                }
+            }
+        }
+    }
+    test::assert_eq(errs, 0u);
+
+    // 1-d along dim 1, on a transposed view
+    f32 box_dat[3];
+    mkBox(View<f32>(box_dat));
+    Array<f32, 2> out({ 17u, 23u });
+    filter(out, src.permute({ 1u, 0u }), 0, View<f32>(box_dat), BorderMode::Clamp);
+    const auto err = out(0, 3) * 3 - (src(3, 0) * 2 + src(3, 1));
+    test::assert_eq((err < 0 ? -err : err) < 1e-4f, true);
+
+    // bad size, bad dim
+    auto thrown = 0u;
+    try {
+        filter(out, src, sobel, BorderMode::Clamp);
+    }
+    catch (const EBadSize&) {
+        ++thrown;
+    }
+    try {
+        filter(dst, src, 2, View<f32>(box_dat), BorderMode::Clamp);
+    }
+    catch (const EOutOfRange&) {
+        ++thrown;
+    }
+    test::assert_eq(thrown, 2u);
+}
+
+nms_test(stencil_bench) {
+    static const u32 $size = 1024;
+
+    Array<f32, 2> src({ $size, $size });
+    Array<f32, 2> dst({ $size, $size });
+    src <<= lins(0.001f, 0.002f);
+
+    f32 gauss_dat[9];
+    mkGauss(View<f32>(gauss_dat), 2.0f);
+
+    Array<f32, 2> kern({ 9u, 9u });
+    for (u32 j = 0; j < 9; ++j) {
+        for (u32 i = 0; i < 9; ++i) {
+            kern(i, j) = gauss_dat[i] * gauss_dat[j];
+        }
+    }
+
+    const auto t0 = clock();
+    ns_stencil::filterN(View<f32, 2>(dst), src, kern, BorderMode::Mirror, 0.0f);
+    const auto t1 = clock();
+    const auto v0 = dst(100, 200);
+    filter(dst, src, kern, BorderMode::Mirror);
+    const auto t2 = clock();
+    const auto v1 = dst(100, 200);
+
+    const auto err = v0 - v1;
+    test::assert_eq((err < 0 ? -err : err) < 1e-4f, true);
+    io::log::info("nms.math.filter: gauss 9x9 on {}x{} f32: direct {:.3f} ms, separable {:.3f} ms",
+        $size, $size, (t1 - t0) * 1000, (t2 - t1) * 1000);
+}
+
+#pragma endregion
+
+}
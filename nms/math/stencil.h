@@ -0,0 +1,363 @@
+#pragma once
+
+#include <nms/core.h>
+#include <nms/math/array.h>
+
+namespace nms::math
+{
+
+/* border mode of stencil, same values as cuda::TexAddressMode */
+enum class BorderMode
+{
+    Wrap    = 0,    // abc|abc
+    Clamp   = 1,    // abc|ccc
+    Mirror  = 2,    // abc|cba
+    Border  = 3,    // abc|000 (the border value)
+};
+
+/* map index `i` into [0, n), returns -1 if out of range in Border mode */
+inline i64 borderIndex(i64 i, i64 n, BorderMode mode) {
+    if (i >= 0 && i < n) {
+        return i;
+    }
+
+    switch (mode) {
+    case BorderMode::Wrap: {
+        const auto m = i % n;
+        return m < 0 ? m + n : m;
+    }
+    case BorderMode::Clamp:
+        return i < 0 ? 0 : n - 1;
+    case BorderMode::Mirror: {
+        auto m = i % (2 * n);
+        m = m < 0 ? m + 2 * n : m;
+        return m < n ? m : 2 * n - 1 - m;
+    }
+    default:
+        return -1;
+    }
+}
+
+namespace ns_stencil
+{
+
+/* copy a row to `buf`, with `lo` items before and `hi` items after */
+template<class T>
+void loadRow(T* buf, const T* row, usize step, usize n, usize lo, usize hi, BorderMode mode, T border) {
+    for (usize i = 0; i < lo; ++i) {
+        const auto m = borderIndex(i64(i) - i64(lo), i64(n), mode);
+        buf[i] = m < 0 ? border : row[usize(m) * step];
+    }
+
+    const auto mid = buf + lo;
+    if (step == 1) {
+        mcpy(mid, row, n);
+    }
+    else {
+        for (usize i = 0; i < n; ++i) {
+            mid[i] = row[i * step];
+        }
+    }
+
+    for (usize i = 0; i < hi; ++i) {
+        const auto m = borderIndex(i64(n + i), i64(n), mode);
+        mid[n + i] = m < 0 ? border : row[usize(m) * step];
+    }
+}
+
+/* dst[i] += w * src[i] */
+template<class T>
+__forceinline void axpy(T* __restrict dst, const T* __restrict src, T w, usize n) {
+    for (usize i = 0; i < n; ++i) {
+        dst[i] += w * src[i];
+    }
+}
+
+/*!
+ * direct n-d filter.
+ * the image is walked row by row (dim 0): each source row is loaded once per kernel row with its borders,
+ * then accumulated tap by tap into the output row, so the inner loops are branch free and vectorizable.
+ */
+template<class T, u32 N>
+void filterN(View<T, N> dst, const View<T, N>& src, const View<T, N>& kern, BorderMode mode, T border) {
+    if (!(dst.size() == src.size())) {
+        NMS_THROW(EBadSize{});
+    }
+    if (dst.count() == 0 || kern.count() == 0) {
+        return;
+    }
+
+    usize lo[N];
+    for (u32 d = 0; d < N; ++d) {
+        lo[d] = kern.size(d) / 2;
+    }
+
+    const auto n0  = src.size(0);
+    const auto k0  = kern.size(0);
+    const auto buf = mnew_align<T>(n0 + k0 - 1);
+    const auto acc = mnew_align<T>(n0);
+
+    usize out[N] = {};      // output row, out[0] is 0
+    for (;;) {
+        mzero(acc, n0);
+
+        usize tap[N] = {};  // kernel row, tap[0] is 0
+        for (;;) {
+            // source row of this kernel row, or all border
+            auto row     = src.data();
+            auto outside = false;
+            auto koff    = usize(0);
+            for (u32 d = 1; d < N; ++d) {
+                const auto m = borderIndex(i64(out[d] + tap[d]) - i64(lo[d]), i64(src.size(d)), mode);
+                if (m < 0) {
+                    outside = true;
+                    break;
+                }
+                row  += usize(m) * src.stride(d);
+                koff += tap[d] * kern.stride(d);
+            }
+
+            if (outside) {
+                for (usize i = 0; i < n0 + k0 - 1; ++i) {
+                    buf[i] = border;
+                }
+                koff = 0;
+                for (u32 d = 1; d < N; ++d) {
+                    koff += tap[d] * kern.stride(d);
+                }
+            }
+            else {
+                loadRow(buf, row, src.stride(0), n0, lo[0], k0 - 1 - lo[0], mode, border);
+            }
+
+            const auto pk = kern.data() + koff;
+            for (usize k = 0; k < k0; ++k) {
+                const auto w = pk[k * kern.stride(0)];
+                if (w != T(0)) {
+                    axpy(acc, buf + k, w, n0);
+                }
+            }
+
+            // next kernel row
+            u32 d = 1;
+            for (; d < N; ++d) {
+                if (++tap[d] < kern.size(d)) {
+                    break;
+                }
+                tap[d] = 0;
+            }
+            if (d == N) {
+                break;
+            }
+        }
+
+        // store
+        auto pd = dst.data();
+        for (u32 d = 1; d < N; ++d) {
+            pd += out[d] * dst.stride(d);
+        }
+        const auto ds = dst.stride(0);
+        for (usize i = 0; i < n0; ++i) {
+            pd[i * ds] = acc[i];
+        }
+
+        // next output row
+        u32 d = 1;
+        for (; d < N; ++d) {
+            if (++out[d] < dst.size(d)) {
+                break;
+            }
+            out[d] = 0;
+        }
+        if (d == N) {
+            break;
+        }
+    }
+
+    mdel_align(buf);
+    mdel_align(acc);
+}
+
+/* offset of an n-d index */
+template<class T, u32 N>
+usize offsetOf(const View<T, N>& view, const usize(&idx)[N]) {
+    usize offset = 0;
+    for (u32 d = 0; d < N; ++d) {
+        offset += idx[d] * view.stride(d);
+    }
+    return offset;
+}
+
+/*!
+ * split a kernel into 1-d factors: kern(i0, i1, ...) = f[0][i0] * f[1][i1] * ...
+ * `fact` should have sum(kern.size(d)) items, returns false if not separable.
+ */
+template<class T, u32 N>
+bool separate(const View<T, N>& kern, T* fact) {
+    // pivot: the max absolute value
+    usize pivot[N] = {};
+    usize idx[N]   = {};
+    auto  vmax     = T(0);
+    for (usize i = 0; i < kern.count(); ++i) {
+        auto rem = i;
+        for (u32 d = 0; d < N; ++d) {
+            idx[d] = rem % kern.size(d);
+            rem   /= kern.size(d);
+        }
+        const auto v = kern.data()[offsetOf(kern, idx)];
+        if ((v < 0 ? -v : v) > vmax) {
+            vmax = v < 0 ? -v : v;
+            mcpy(pivot, idx, N);
+        }
+    }
+    if (vmax == T(0)) {
+        return false;
+    }
+
+    // factors: the lines through the pivot
+    const auto vp = kern.data()[offsetOf(kern, pivot)];
+    auto f = fact;
+    for (u32 d = 0; d < N; ++d) {
+        mcpy(idx, pivot, N);
+        for (usize x = 0; x < kern.size(d); ++x) {
+            idx[d] = x;
+            f[x]   = kern.data()[offsetOf(kern, idx)];
+        }
+        for (u32 k = 0; d == 0 && k + 1 < N; ++k) {
+            for (usize x = 0; x < kern.size(0); ++x) {
+                f[x] /= vp;
+            }
+        }
+        f += kern.size(d);
+    }
+
+    // verify
+    const auto eps = vmax * T(1e-5);
+    for (usize i = 0; i < kern.count(); ++i) {
+        auto rem = i;
+        auto val = T(1);
+        auto off = usize(0);
+        f = fact;
+        for (u32 d = 0; d < N; ++d) {
+            idx[d] = rem % kern.size(d);
+            rem   /= kern.size(d);
+            val   *= f[idx[d]];
+            f     += kern.size(d);
+        }
+        off = offsetOf(kern, idx);
+        const auto err = kern.data()[off] - val;
+        if ((err < 0 ? -err : err) > eps) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+/* test if a kernel is separable (rank 1) */
+template<class T, u32 N>
+bool isSeparable(const View<T, N>& kern) {
+    usize cnt = 0;
+    for (u32 d = 0; d < N; ++d) {
+        cnt += kern.size(d);
+    }
+    const auto fact = mnew<T>(cnt);
+    const auto ret  = ns_stencil::separate(kern, fact);
+    mdel(fact);
+    return ret;
+}
+
+/*!
+ * 1-d filter along `dim`: dst(..x..) = sum(kern[k] * src(..x+k-r..)), r = kern.count()/2.
+ * the kernel is not flipped (correlation), as image filters.
+ * `dst` should not overlap `src`.
+ */
+template<class T, u32 N>
+void filter(View<T, N> dst, const View<T, N>& src, u32 dim, const View<T>& kern, BorderMode mode, T border = T(0)) {
+    if (dim >= N) {
+        NMS_THROW(EOutOfRange{});
+    }
+
+    usize size[N];
+    usize step[N];
+    for (u32 d = 0; d < N; ++d) {
+        size[d] = d == dim ? kern.count() : 1;
+        step[d] = d == dim ? 1 : 0;
+    }
+    const View<T, N> kn(const_cast<T*>(kern.data()), size, step);
+    ns_stencil::filterN(dst, src, kn, mode, border);
+}
+
+/*!
+ * n-d filter: dst(x) = sum(kern(k) * src(x+k-r)), r = kern.size()/2.
+ * a separable (rank 1) kernel is split, and applied dim by dim: O(sum(k)) instead of O(prod(k)) per item.
+ * the kernel is not flipped (correlation), as image filters.
+ * `dst` should not overlap `src`.
+ */
+template<class T, u32 N>
+void filter(View<T, N> dst, const View<T, N>& src, const View<T, N>& kern, BorderMode mode, T border = T(0)) {
+    if (!(dst.size() == src.size())) {
+        NMS_THROW(EBadSize{});
+    }
+
+    usize cnt = 0;
+    for (u32 d = 0; d < N; ++d) {
+        cnt += kern.size(d);
+    }
+
+    // the factors are freed on every path, the passes may throw
+    Array<T> facts({ cnt });
+    const auto fact = facts.data();
+    if (N == 1 || cnt >= kern.count() || !ns_stencil::separate(kern, fact)) {
+        ns_stencil::filterN(dst, src, kern, mode, border);
+        return;
+    }
+
+    // dim by dim: src -> tmp -> ... -> dst
+    // in Border mode, the border of the later passes is the border filtered by the earlier factors.
+    Array<T, N> tmp[2] = { Array<T, N>(src.size().data_), Array<T, N>(src.size().data_) };
+    auto f = fact;
+    auto b = border;
+    for (u32 d = 0; d < N; ++d) {
+        const auto  n   = kern.size(d);
+        const View<T, N>& in  = d == 0 ? src : static_cast<const View<T, N>&>(tmp[(d + 1) % 2]);
+        View<T, N>        out = d + 1 == N ? dst : View<T, N>(tmp[d % 2]);
+        filter(out, in, d, View<T>(f, n), mode, b);
+
+        auto s = T(0);
+        for (usize k = 0; k < n; ++k) {
+            s += f[k];
+        }
+        b *= s;
+        f += n;
+    }
+}
+
+/* fill a normalized gaussian kernel */
+template<class T>
+void mkGauss(View<T> kern, T sigma) {
+    const auto n = kern.count();
+    const auto c = T(n - 1) / 2;
+
+    auto sum = T(0);
+    for (usize i = 0; i < n; ++i) {
+        const auto x = (T(i) - c) / sigma;
+        kern[i] = T(exp(-x * x / 2));
+        sum += kern[i];
+    }
+    for (usize i = 0; i < n; ++i) {
+        kern[i] /= sum;
+    }
+}
+
+/* fill a box kernel */
+template<class T>
+void mkBox(View<T> kern) {
+    const auto n = kern.count();
+    for (usize i = 0; i < n; ++i) {
+        kern[i] = T(1) / T(n);
+    }
+}
+
+}
@@ -1,6 +1,12 @@
 ﻿#pragma once
 
 #include <nms/core.h>
+#include <nms/math/base.h>
+
+#if defined(__SSE__) || defined(_M_X64)
+#define NMS_MATH_SSE
+#include <xmmintrin.h>
+#endif
 
 namespace nms::math
 {
@@ -47,10 +53,16 @@ auto view_test_xy() -> decltype(_view_test_xy<X, Y>(Version<2>{})) {
 template<class F, class ...T>
 struct Parallel;
 
+namespace ns_jit
+{
+struct Emit;
+}
+
 template<class F, class T>
 struct Parallel<F, T>
 {
     using Tview = Parallel;
+    friend struct ns_jit::Emit;
 
     constexpr static const auto $rank = T::$rank;
 
@@ -71,21 +83,76 @@ protected:
     T   t_;
 };
 
+/* size of 2 broadcast operands: 0 is any size, 1 is repeated */
+template<class T, class U>
+constexpr usize broadcastSize(T x, U y) noexcept {
+    return x <= 1 ? (y == 0 ? usize(x) : usize(y))
+        :  y <= 1 ? usize(x)
+        :  usize(nms::min(usize(x), usize(y)));
+}
+
+/*!
+ * operand of an expression, indexed with the indices of the result (numpy broadcasting).
+ * the result may have more dims (appended after the operand's dims): they are dropped.
+ * the dims of size 1 are repeated: their index is masked to 0.
+ * rank 0 operands (Scalar, Eye) get all indices.
+ * the layout is mirrored by nms::math::Broadcast in nms/cuda/kernel.h: keep them the same.
+ */
+template<class X>
+struct Broadcast
+{
+    using Tview = Broadcast;
+    friend struct ns_jit::Emit;
+
+    constexpr static const auto $rank = X::$rank;
+
+    Broadcast(const X& x)
+        : x_(x) {
+        for (u32 d = 0; d < $rank; ++d) {
+            mask_[d] = x_.size(d) == 1 ? usize(0) : ~usize(0);
+        }
+    }
+
+    template<class I>
+    usize size(I idx) const noexcept {
+        return $rank == 0 || u32(idx) < $rank ? usize(x_.size(idx)) : usize(1);
+    }
+
+    template<class ...I>
+    auto operator()(I ...idx) const noexcept {
+        return _at(Seq<$rank>{}, idx...);
+    }
+
+protected:
+    X       x_;
+    usize   mask_[$rank == 0 ? 1 : $rank];
+
+    template<u32 ...D, class ...I>
+    auto _at(U32<D...>, I ...idx) const noexcept {
+        if constexpr($rank == 0) {
+            return x_(idx...);
+        }
+        else {
+            const usize ids[] = { usize(idx)... };
+            return x_((ids[D] & mask_[D])...);
+        }
+    }
+};
+
 template<class F, class X, class Y>
 struct Parallel<F, X, Y>
 {
     using Tview = Parallel;
+    friend struct ns_jit::Emit;
 
-    constexpr static const auto $rank = X::$rank | Y::$rank;
+    constexpr static const auto $rank = X::$rank > Y::$rank ? X::$rank : Y::$rank;
 
     Parallel(const X& x, const Y& y)
         : x_(x), y_(y) {}
 
     template<class I>
     auto size(I idx) const noexcept {
-        const auto sx = x_.size(idx);
-        const auto sy = y_.size(idx);
-        return X::$rank == 0 ? sy : Y::$rank == 0 ? sx : nms::min(sx, sy);
+        return broadcastSize(x_.size(idx), y_.size(idx));
     }
 
     template<class ...I>
@@ -94,8 +161,8 @@ struct Parallel<F, X, Y>
     }
 
 protected:
-    X   x_;
-    Y   y_;
+    Broadcast<X>    x_;
+    Broadcast<Y>    y_;
 };
 
 /* make Parallel<F(x)> */
@@ -143,7 +210,7 @@ struct Reduce<F, X>
         }
 
         auto ret = F::run(x_(0, idx...), x_(1, idx...));
-        for (u32 i = 2; i < n; ++i) {
+        for (Tmutable<decltype(n)> i = 2; i < n; ++i) {
             ret = F::run(ret, x_(i, idx...));
         }
 
@@ -166,25 +233,209 @@ struct Texec
 {
     template<class Tfunc, class Tret, class ...Targs>
     void foreach(Tfunc fun, Tret& ret, const Targs& ...args) {
-        _foreach(U32<Tret::$rank>{}, fun, ret, args...);
+        _foreach(U32<Tret::$rank>{}, fun, ret, Broadcast<Targs>(args)...);
+    }
+
+    /* view to view: walk both views row by row */
+    template<class Tfunc, class T, class U, u32 N>
+    void foreach(Tfunc func, View<T, N>& ret, const View<U, N>& arg) {
+        if (!(ret.size() == arg.size())) {
+            const auto barg = broadcastView(arg, ret.size());
+            if (barg.size() == ret.size()) {
+                foreach(func, ret, barg);
+            }
+            else {
+                _foreach(U32<N>{}, func, ret, arg);
+            }
+            return;
+        }
+
+        // the rows of ret and arg are along different dims: copy by tiles
+        const auto dim = unitDim(arg);
+        if (ret.stride(0) == 1 && dim != 0) {
+            _foreachTiled(func, ret, arg, dim);
+            return;
+        }
+
+        const auto inner = min(ret.linearRank(), arg.linearRank());
+        ViewCursor<T, N>        rc(ret, inner);
+        ViewCursor<const U, N>  ac(arg, inner);
+        for (; !rc.isEnd(); rc.next(), ac.next()) {
+            const auto n  = rc.count();
+            const auto rs = rc.step();
+            const auto as = ac.step();
+            const auto pr = rc.data();
+            const auto pa = ac.data();
+
+            if (rs == 1 && as == 1) {
+                for (usize i = 0; i < n; ++i) {
+                    func(pr[i], pa[i]);
+                }
+            }
+            else {
+                for (usize i = 0; i < n; ++i) {
+                    func(pr[i * rs], pa[i * as]);
+                }
+            }
+        }
+    }
+
+    /* view to view of lower rank: broadcast, then walk row by row */
+    template<class Tfunc, class T, class U, u32 N, u32 M>
+    void foreach(Tfunc func, View<T, N>& ret, const View<U, M>& arg) {
+        static_assert(M < N, "nms.math.Texec.foreach: $rank not match");
+        foreach(func, ret, broadcastView(arg, ret.size()));
+    }
+
+    /* scalar to view: walk the view row by row */
+    template<class Tfunc, class T, class U, u32 N>
+    void foreach(Tfunc func, View<T, N>& ret, const Scalar<U>& arg) {
+        const auto& val = arg();
+        for (auto rc = ret.cursor(); !rc.isEnd(); rc.next()) {
+            const auto n  = rc.count();
+            const auto rs = rc.step();
+            const auto pr = rc.data();
+            for (usize i = 0; i < n; ++i) {
+                func(pr[i * rs], val);
+            }
+        }
     }
 
 protected:
+    /* repeat the missing dims and the dims of size 1 of `view` by stride 0, to `size` */
+    template<class U, u32 M, u32 N>
+    static View<U, N> broadcastView(const View<U, M>& view, const Vec<usize, N>& size) {
+        usize dims[N];
+        usize step[N];
+        for (u32 i = 0; i < N; ++i) {
+            const auto bcast = i >= M || view.size(i) == 1;
+            dims[i] = bcast ? size[i] : view.size(i);
+            step[i] = bcast ? 0       : view.stride(i);
+        }
+        return { const_cast<U*>(view.data()), dims, step };
+    }
+
+    /* tile size of transposed copy: 2 tiles of f32 fit in L1 */
+    constexpr static const usize $tile = 16;
+
+    /* the dim whose stride is 1, or 0 if none */
+    template<class U, u32 N>
+    static u32 unitDim(const View<U, N>& view) {
+        for (u32 i = 0; i < N; ++i) {
+            if (view.stride(i) == 1 && view.size(i) > 1) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    /*!
+     * ret is contiguous along dim 0, arg is contiguous along dim `d`.
+     * walk the (0, d) planes by tiles, so both sides stay in cache.
+     */
+    template<class Tfunc, class T, class U, u32 N>
+    static void _foreachTiled(Tfunc func, View<T, N>& ret, const View<U, N>& arg, u32 d) {
+        const auto n0 = ret.size(0);
+        const auto nd = ret.size(d);
+        const auto rs = ret.stride(d);
+        const auto as = arg.stride(0);
+
+        // empty: a dim of size 0 may be one of the carried dims
+        if (ret.count() == 0) {
+            return;
+        }
+
+        // the other dims: walked with carry
+        usize idx[N]    = {};
+        auto  pr        = ret.data();
+        auto  pa        = arg.data();
+        for (;;) {
+            for (usize jd = 0; jd < nd; jd += $tile) {
+                for (usize j0 = 0; j0 < n0; j0 += $tile) {
+                    const auto m0 = min(n0 - j0, $tile);
+                    const auto md = min(nd - jd, $tile);
+                    _tile(func, pr + j0 + jd * rs, pa + j0 * as + jd, m0, md, rs, as);
+                }
+            }
+
+            u32 i = 1;
+            for (; i < N; ++i) {
+                if (i == d) {
+                    continue;
+                }
+                pr += ret.stride(i);
+                pa += arg.stride(i);
+                if (++idx[i] < ret.size(i)) {
+                    break;
+                }
+                pr -= ret.stride(i) * ret.size(i);
+                pa -= arg.stride(i) * arg.size(i);
+                idx[i] = 0;
+            }
+            if (i == N) {
+                return;
+            }
+        }
+    }
+
+    /* ret(i, k) = pr[i + k*rs], arg(i, k) = pa[i*as + k] */
+    template<class Tfunc, class T, class U>
+    static void _tile(Tfunc func, T* pr, const U* pa, usize m0, usize md, usize rs, usize as) {
+        for (usize k = 0; k < md; ++k) {
+            for (usize i = 0; i < m0; ++i) {
+                func(pr[i + k * rs], pa[i * as + k]);
+            }
+        }
+    }
+
+#ifdef NMS_MATH_SSE
+    /* f32 copy: full tiles are transposed in registers, 4x4 at a time */
+    static void _tile(Ass2 func, f32* pr, const f32* pa, usize m0, usize md, usize rs, usize as) {
+        if (m0 != $tile || md != $tile) {
+            for (usize k = 0; k < md; ++k) {
+                for (usize i = 0; i < m0; ++i) {
+                    func(pr[i + k * rs], pa[i * as + k]);
+                }
+            }
+            return;
+        }
+
+        for (usize kb = 0; kb < $tile; kb += 4) {
+            for (usize ib = 0; ib < $tile; ib += 4) {
+                const auto src = pa + ib * as + kb;
+                auto r0 = _mm_loadu_ps(src + 0 * as);
+                auto r1 = _mm_loadu_ps(src + 1 * as);
+                auto r2 = _mm_loadu_ps(src + 2 * as);
+                auto r3 = _mm_loadu_ps(src + 3 * as);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+                const auto dst = pr + ib + kb * rs;
+                _mm_storeu_ps(dst + 0 * rs, r0);
+                _mm_storeu_ps(dst + 1 * rs, r1);
+                _mm_storeu_ps(dst + 2 * rs, r2);
+                _mm_storeu_ps(dst + 3 * rs, r3);
+            }
+        }
+    }
+#endif
+
     template<class Tfunc, class Tret, class Targ>
     void _foreach(U32<1>, Tfunc func, Tret& ret, const Targ& arg) {
+        using Tsize     = typename Tret::Tsize;
         const auto size = ret.size();
 
-        for (u32 i0 = 0; i0 < size[0]; ++i0) {
+        for (Tsize i0 = 0; i0 < size[0]; ++i0) {
             func(ret(i0), arg(i0));
         }
     }
 
     template<class Tfunc, class Tret, class Targ>
     void _foreach(U32<2>, Tfunc func, Tret& ret, const Targ& arg) {
+        using Tsize     = typename Tret::Tsize;
         const auto size = ret.size();
 
-        for (u32 i1 = 0; i1 < size[1]; ++i1) {
-            for (u32 i0 = 0; i0 < size[0]; ++i0) {
+        for (Tsize i1 = 0; i1 < size[1]; ++i1) {
+            for (Tsize i0 = 0; i0 < size[0]; ++i0) {
                 func(ret(i0, i1), arg(i0, i1));
             }
         }
@@ -192,11 +443,12 @@ protected:
 
     template<class Tfunc, class Tret, class Targ>
     void _foreach(U32<3>, Tfunc func, Tret& ret, const Targ& arg) {
+        using Tsize     = typename Tret::Tsize;
         const auto size = ret.size();
 
-        for (u32 i2 = 0; i2 < size[2]; ++i2) {
-            for (u32 i1 = 0; i1 < size[1]; ++i1) {
-                for (u32 i0 = 0; i0 < size[0]; ++i0) {
+        for (Tsize i2 = 0; i2 < size[2]; ++i2) {
+            for (Tsize i1 = 0; i1 < size[1]; ++i1) {
+                for (Tsize i0 = 0; i0 < size[0]; ++i0) {
                     func(ret(i0, i1, i2), arg(i0, i1, i2));
                 }
             }
@@ -205,12 +457,13 @@ protected:
 
     template<class Tfunc, class Tret, class Targ>
     void _foreach(U32<4>, Tfunc fun, Tret& ret, const Targ& arg) {
+        using Tsize     = typename Tret::Tsize;
         const auto size = ret.size();
 
-        for (u32 i3 = 0; i3 < size[3]; ++i3) {
-            for (u32 i2 = 0; i2 < size[2]; ++i2) {
-                for (u32 i1 = 0; i1 < size[1]; ++i1) {
-                    for (u32 i0 = 0; i0 < size[0]; ++i0) {
+        for (Tsize i3 = 0; i3 < size[3]; ++i3) {
+            for (Tsize i2 = 0; i2 < size[2]; ++i2) {
+                for (Tsize i1 = 0; i1 < size[1]; ++i1) {
+                    for (Tsize i0 = 0; i0 < size[0]; ++i0) {
                         fun(ret(i0, i1, i2, i3), arg(i0, i1, i2, i3));
                     }
                 }
@@ -253,10 +506,11 @@ bool check_size(const T& t) {
 
 template<class T, class U, class ...R>
 bool check_size(const T& t, const U& u, const R& ...r) {
-    static_assert(T::$rank == U::$rank || U::$rank == 0, "nms.math._check_size: $rank not match");
+    static_assert(U::$rank <= T::$rank, "nms.math._check_size: $rank not match");
 
-    for (u32 i = 0; i < T::$rank; ++i) {
-        if (u.size(i) != 0 && u.size(i) > t.size(i)) {
+    // 0: any size, 1: broadcast
+    for (u32 i = 0; i < U::$rank; ++i) {
+        if (u.size(i) > 1 && u.size(i) > t.size(i)) {
             return false;
         }
     }
@@ -279,6 +533,210 @@ bool foreach(Tfunc func, Tret& ret, const Targs& ...args) {
 
 #pragma endregion
 
+#pragma region fuse
+/* lazy `func(ret, arg)` for all items, see fuse */
+template<class Tfunc, class Tret, class Targ>
+struct FuseAssign
+{
+    constexpr static const auto $rank = Tret::$rank;
+
+    FuseAssign(const Tret& ret, const Targ& arg)
+        : ret_(ret), arg_(arg), chk_(check_size(ret, arg))
+    {}
+
+    usize size(u32 idx) const noexcept {
+        return ret_.size(idx);
+    }
+
+    /* the result should cover the domain */
+    template<u32 N>
+    bool check(const usize(&dims)[N]) const noexcept {
+        for (u32 d = 0; d < $rank; ++d) {
+            if (ret_.size(d) != dims[d]) {
+                return false;
+            }
+        }
+        return chk_;
+    }
+
+    template<u32 ...D, u32 N>
+    __forceinline void run(U32<D...>, const usize(&idx)[N]) {
+        Tfunc{}(ret_(idx[D]...), arg_(idx[D]...));
+    }
+
+protected:
+    Tret            ret_;
+    Broadcast<Targ> arg_;
+    bool            chk_;
+};
+
+/* lazy `acc = F::run(acc, arg)` for all items, see fuse */
+template<class F, class T, class Targ>
+struct FuseFold
+{
+    constexpr static const auto $rank = Targ::$rank;
+
+    FuseFold(T& acc, const Targ& arg)
+        : acc_(acc), arg_(arg)
+    {}
+
+    usize size(u32 idx) const noexcept {
+        return arg_.size(idx);
+    }
+
+    /* the domain should cover the input: each dim is any size (0), repeated (1), or the same */
+    template<u32 N>
+    bool check(const usize(&dims)[N]) const noexcept {
+        for (u32 d = 0; d < $rank; ++d) {
+            const auto n = arg_.size(d);
+            if (n > 1 && n != dims[d]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<u32 ...D, u32 N>
+    __forceinline void run(U32<D...>, const usize(&idx)[N]) {
+        acc_ = F::run(acc_, arg_(idx[D]...));
+    }
+
+protected:
+    T&              acc_;
+    Broadcast<Targ> arg_;
+};
+
+/* lazy `ret <<= arg`, see fuse */
+template<class Tret, class Targ>
+auto assign(Tret& ret, const Targ& arg) {
+    using Vret = typename Tret::Tview;
+    using Varg = decltype(view_cast(arg));
+    return FuseAssign<Ass2, Vret, Varg>{ ret, view_cast(arg) };
+}
+
+/* lazy `ret += arg`, see fuse */
+template<class Tret, class Targ>
+auto accum(Tret& ret, const Targ& arg) {
+    using Vret = typename Tret::Tview;
+    using Varg = decltype(view_cast(arg));
+    return FuseAssign<Add2, Vret, Varg>{ ret, view_cast(arg) };
+}
+
+/* lazy reduce of all items into `acc`: F = Add, Max, Min, see fuse */
+template<class F = Add, class T, class Targ>
+auto fold(T& acc, const Targ& arg) {
+    using Varg = decltype(view_cast(arg));
+    return FuseFold<F, T, Varg>{ acc, view_cast(arg) };
+}
+
+template<class ...Tops>
+constexpr u32 fuseRank() {
+    const u32 ranks[] = { u32(Tops::$rank)... };
+    u32 ret = 0;
+    for (auto r : ranks) {
+        ret = r > ret ? r : ret;
+    }
+    return ret;
+}
+
+/*!
+ * evaluate several assign/accum/fold in one traversal, so the shared inputs are read once:
+ *   fuse(assign(y, x * 2), fold(sum, x), fold(sum2, x * x));
+ * the domain is the broadcast size of all results and folded expressions, walked row by row.
+ * returns false (and does nothing) if the sizes not match.
+ */
+template<class ...Tops>
+bool fuse(Tops ...ops) {
+    constexpr static const u32 N = fuseRank<Tops...>();
+    static_assert(N > 0, "nms.math.fuse: $rank should > 0");
+
+    usize dims[N];
+    for (u32 d = 0; d < N; ++d) {
+        const usize sizes[] = { (d < Tops::$rank ? ops.size(d) : usize(1))... };
+        dims[d] = 0;
+        for (auto s : sizes) {
+            dims[d] = broadcastSize(dims[d], s);
+        }
+    }
+
+    const bool oks[] = { ops.check(dims)... };
+    for (auto ok : oks) {
+        if (!ok) {
+            return false;
+        }
+    }
+    for (u32 d = 0; d < N; ++d) {
+        if (dims[d] == 0) {
+            return true;
+        }
+    }
+
+    usize idx[N] = {};
+    for (;;) {
+        for (idx[0] = 0; idx[0] < dims[0]; ++idx[0]) {
+            (ops.run(Seq<N>{}, idx), ...);
+        }
+
+        u32 d = 1;
+        for (; d < N; ++d) {
+            if (++idx[d] < dims[d]) {
+                break;
+            }
+            idx[d] = 0;
+        }
+        if (d >= N) {
+            break;
+        }
+    }
+    return true;
+}
+
+#pragma endregion
+
+#pragma region rowwise
+/* a row of a view: data[i * step] */
+template<class T>
+struct ViewRow
+{
+    T*    data;
+    usize step;
+
+    __forceinline T& operator[](usize i) const noexcept {
+        return data[i * step];
+    }
+};
+
+/* walk 2 views of the same size, row by row: func(n, ViewRow y, ViewRow a). only y is written. */
+template<class Tfunc, class Y, class A, u32 N>
+void rowwise(Tfunc func, const View<Y, N>& y, const View<A, N>& a) {
+    if (!(y.size() == a.size())) {
+        NMS_THROW(EBadSize{});
+    }
+    const auto inner = min(y.linearRank(), a.linearRank());
+    ViewCursor<Y, N>        yc(y, inner);
+    ViewCursor<A, N>        ac(a, inner);
+    for (; !yc.isEnd(); yc.next(), ac.next()) {
+        func(yc.count(), ViewRow<Y>{ yc.data(), yc.step() }, ViewRow<A>{ ac.data(), ac.step() });
+    }
+}
+
+/* walk 3 views of the same size, row by row: func(n, ViewRow y, ViewRow a, ViewRow b). only y is written. */
+template<class Tfunc, class Y, class A, class B, u32 N>
+void rowwise(Tfunc func, const View<Y, N>& y, const View<A, N>& a, const View<B, N>& b) {
+    if (!(y.size() == a.size()) || !(y.size() == b.size())) {
+        NMS_THROW(EBadSize{});
+    }
+    const auto inner = min(min(y.linearRank(), a.linearRank()), b.linearRank());
+    ViewCursor<Y, N>        yc(y, inner);
+    ViewCursor<A, N>        ac(a, inner);
+    ViewCursor<B, N>        bc(b, inner);
+    for (; !yc.isEnd(); yc.next(), ac.next(), bc.next()) {
+        func(yc.count(), ViewRow<Y>{ yc.data(), yc.step() }, ViewRow<A>{ ac.data(), ac.step() }, ViewRow<B>{ bc.data(), bc.step() });
+    }
+}
+
+#pragma endregion
+
 #pragma region functions
 
 #define NMS_IVIEW_FOREACH(op, type)                     \
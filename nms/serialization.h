@@ -3,3 +3,4 @@
 #include <nms/serialization/node.h>
 #include <nms/serialization/json.h>
 #include <nms/serialization/xml.h>
+#include <nms/serialization/query.h>
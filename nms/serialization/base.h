@@ -12,7 +12,7 @@ namespace json {}
 struct Node;
 struct NodeEx;
 
-NMS_ENUM_EX(enum class Type : u16, Type,
+NMS_ENUM_EX(enum class Type : u8, Type,
     null,
     boolean,
 
@@ -94,6 +94,18 @@ struct ISerializable
 {
     friend struct NodeEx;
 
+public:
+    /*!
+     * visit each property of obj: func(name, value)
+     * used by the direct (tree-less) formatters/parsers.
+     */
+    template<class T, class F>
+    static void _foreach(T& obj, F&& func) {
+#define call_foreach_impl(n, ...)    _foreach_impl(I32<n>{}, &obj, &func);
+        NMSCPP_LOOP(99, call_foreach_impl);
+#undef call_foreach_impl
+    }
+
 protected:
     template<class T>
     static void _serialize(NodeEx& node, const T& obj) {
@@ -110,6 +122,21 @@ protected:
     }
 
 private:
+    // foreach-impl
+    template<class T, class F, i32 I>
+    static auto _foreach_impl(I32<I>, T* pobj, F* pfunc)->$when<(I < Tmutable<T>::_$property_cnt)> {
+        auto obj_item = (*pobj)[I32<I>{}];
+        (*pfunc)(obj_item.name, obj_item.value);
+        return;
+    }
+
+    // foreach-impl
+    template<class T, i32 I >
+    static auto _foreach_impl(I32<I>, T* pobj, ...) -> $when<(I >= Tmutable<T>::_$property_cnt)> {
+        (void)pobj;
+        return;
+    }
+
     // serialize-impl
     template<class T, i32 I>
     static auto _serialize_impl(I32<I> idx, const T* pobj, NodeEx* pnod)->$when<(I < T::_$property_cnt)> {
@@ -1,4 +1,5 @@
 #include <nms/serialization/json.h>
+#include <nms/serialization/writer.h>
 #include <nms/io/log.h>
 #include <nms/io/console.h>
 #include <nms/test.h>
@@ -7,84 +8,260 @@ namespace nms::serialization::json
 {
 
 // format
-void formatNode(String& buf, const NodeEx& node, i32 level=0) {
-    StrView fmt;
-
-    auto& v = node.val();
-
-    switch (v.type()) {
-    case Type::null:    formatImpl(buf, fmt, "");               break;
-    case Type::boolean: formatImpl(buf, fmt, v.bool_val_);      break;
-    case Type::u16:     formatImpl(buf, fmt, v.u16_val_);       break;
-    case Type::i16:     formatImpl(buf, fmt, v.i16_val_);       break;
-    case Type::u32:     formatImpl(buf, fmt, v.u32_val_);       break;
-    case Type::i32:     formatImpl(buf, fmt, v.i32_val_);       break;
-    case Type::u64:     formatImpl(buf, fmt, v.u64_val_);       break;
-    case Type::i64:     formatImpl(buf, fmt, v.i64_val_);       break;
-    case Type::f32:     formatImpl(buf, fmt, v.f32_val_);       break;
-    case Type::f64:     formatImpl(buf, fmt, v.f64_val_);       break;
-
-    case Type::datetime:
-        buf += "\"";
-        DateTime(v.i64_val_).format(buf, fmt);
-        buf += "\"";
-        break;
+struct Formatter
+{
+    u32 indent_;    // indent width, 0: compact
 
-    case Type::number: {
-        formatImpl(buf, fmt, v.str());
-        break;
+    template<class Sink>
+    void newline(Sink& out, i32 level) const {
+        if (indent_ == 0) {
+            return;
+        }
+        out.put('\n');
+        out.fill(' ', u32(level) * indent_);
     }
 
-    case Type::key: case Type::string: {
-        buf += "\"";
-        formatImpl(buf, fmt, v.str());
-        buf += "\"";
-        break;
+    template<class Sink>
+    void str(Sink& out, const Node& v) const {
+        out.put('"');
+        if (v.isEscaped()) {
+            out.put(v.str());
+        }
+        else {
+            putJsonStr(out, v.str());
+        }
+        out.put('"');
     }
 
-    case Type::array: {
-        buf += "[\n";
+    template<class Sink>
+    void node(Sink& out, const NodeEx& node, i32 level) const {
+        auto& v = node.val();
+
+        switch (v.type()) {
+        case Type::null:    out.put("null");                                        break;
+        case Type::boolean: out.put(v.bool_val_ ? StrView("true") : StrView("false")); break;
+        case Type::u8:      putNum(out, v.u8_val_);     break;
+        case Type::i8:      putNum(out, v.i8_val_);     break;
+        case Type::u16:     putNum(out, v.u16_val_);    break;
+        case Type::i16:     putNum(out, v.i16_val_);    break;
+        case Type::u32:     putNum(out, v.u32_val_);    break;
+        case Type::i32:     putNum(out, v.i32_val_);    break;
+        case Type::u64:     putNum(out, v.u64_val_);    break;
+        case Type::i64:     putNum(out, v.i64_val_);    break;
+        case Type::f32:     putNum(out, v.f32_val_);    break;
+        case Type::f64:     putNum(out, v.f64_val_);    break;
+
+        case Type::datetime: {
+            U8String<64> tmp;
+            DateTime(v.i64_val_).format(tmp, {});
+            out.put('"');
+            out.put(tmp);
+            out.put('"');
+            break;
+        }
+
+        case Type::number:
+            out.put(v.str());
+            break;
+
+        case Type::key: case Type::string:
+            str(out, v);
+            break;
 
-        for (auto itr = node.begin(); itr != node.end(); ) {
-            for (auto i = 0; i < (level+1) * 4; ++i) {
-                buf += ' ';
+        case Type::array: {
+            out.put('[');
+            for (auto itr = node.begin(); itr != node.end(); ) {
+                newline(out, level + 1);
+                this->node(out, *itr, level + 1);
+                if (++itr != node.end()) {
+                    out.put(',');
+                }
             }
-            formatNode(buf, *itr, level + 1);
-            formatImpl(buf, fmt, (++itr == node.end()) ? StrView{ "\n" } : StrView{ ",\n" });
+            newline(out, level);
+            out.put(']');
+            break;
         }
 
-        for (auto i = 0; i < level * 4; ++i) buf += ' ';
-        buf += "]";
-        break;
+        case Type::object: {
+            out.put('{');
+            for (auto itr = node.begin(); itr != node.end(); ) {
+                const auto val = *itr;
+                newline(out, level + 1);
+                str(out, val.keyNode());
+                out.put(indent_ == 0 ? StrView(":") : StrView(": "));
+                this->node(out, val, level + 1);
+                if (++itr != node.end()) {
+                    out.put(',');
+                }
+            }
+            newline(out, level);
+            out.put('}');
+            break;
+        }
+
+        default:
+            break;
+        }
     }
-    case Type::object: {
-        buf += "{\n";
+};
 
-        for (auto itr = node.begin(); itr != node.end();) {
-            for (auto i = 0; i < (level+1) * 4; ++i) {
-                buf += ' ';
-            }
-            buf += "\"";
-            buf += itr.key();
-            buf += "\": ";
-            formatNode(buf, *itr, level + 1);
-            formatImpl(buf, fmt, (++itr == node.end()) ? StrView{ "\n" } : StrView{ ",\n" });
+/* fmt: json(4 spaces), json2(2 spaces), json0(compact) */
+NMS_API void formatImpl(String& buf, const NodeEx& tree, StrView fmt) {
+    const Formatter formatter{ indentOf(fmt, 4) };
+    formatText(buf, [&](auto& sink) { formatter.node(sink, tree, 0); });
+}
+
+#pragma region direct
+NMS_API void formatIndent(String& buf, i32 level) {
+    buf.appends(u32(level * 4), ' ');
+}
+
+NMS_API void formatVal(String& buf, StrView val, i32 /*level*/) {
+    TextAppender out{ buf };
+    out.put('"');
+    putJsonStr(out, val);
+    out.put('"');
+}
+
+NMS_API void formatVal(String& buf, const DateTime& val, i32 /*level*/) {
+    buf += "\"";
+    val.format(buf, {});
+    buf += "\"";
+}
+
+static bool isBlank(char c);
+
+NMS_API char Scanner::peek() {
+    while (ptr_ < end_ && isBlank(*ptr_)) {
+        ++ptr_;
+    }
+    return ptr_ < end_ ? *ptr_ : '\0';
+}
+
+NMS_API void Scanner::expect(char c) {
+    if (peek() != c) {
+        NMS_THROW(EParseFailed{});
+    }
+    ++ptr_;
+}
+
+NMS_API bool Scanner::accept(char c) {
+    if (peek() != c) {
+        return false;
+    }
+    ++ptr_;
+    return true;
+}
+
+NMS_API StrView Scanner::str() {
+    expect('"');
+
+    // "abcdefg"
+    //  ^      ^
+    //  b      ptr
+    const auto b = ptr_;
+    while (ptr_ < end_ && *ptr_ != '"') {
+        ptr_ += (*ptr_ == '\\') ? 2 : 1;
+    }
+    if (ptr_ >= end_) {
+        NMS_THROW(EParseFailed{});
+    }
+    const auto s = StrView{ b, u32(ptr_ - b) };
+    ++ptr_;
+    return s;
+}
+
+NMS_API StrView Scanner::num() {
+    peek();
+
+    const auto b = ptr_;
+    while (ptr_ < end_) {
+        const auto c = *ptr_;
+        if (!(('0' <= c && c <= '9') || c == '+' || c == '-' || c == '.' || c == 'e' || c == 'E')) {
+            break;
         }
+        ++ptr_;
+    }
+    if (ptr_ == b) {
+        NMS_THROW(EParseFailed{});
+    }
+    return { b, u32(ptr_ - b) };
+}
 
-        for (auto i = 0; i < level * 4; ++i) buf += ' ';
-        buf += "}";
-        break;
+NMS_API StrView Scanner::word() {
+    peek();
+
+    const auto b = ptr_;
+    while (ptr_ < end_ && 'a' <= *ptr_ && *ptr_ <= 'z') {
+        ++ptr_;
+    }
+    if (ptr_ == b) {
+        NMS_THROW(EParseFailed{});
     }
+    return { b, u32(ptr_ - b) };
+}
+
+NMS_API void Scanner::skip() {
+    switch (peek()) {
+    case '"':
+        str();
+        break;
+
+    case '[':
+        ++ptr_;
+        if (accept(']')) {
+            break;
+        }
+        do {
+            skip();
+        } while (accept(','));
+        expect(']');
+        break;
+
+    case '{':
+        ++ptr_;
+        if (accept('}')) {
+            break;
+        }
+        do {
+            str();
+            expect(':');
+            skip();
+        } while (accept(','));
+        expect('}');
+        break;
+
+    case 't': case 'f': case 'n':
+        word();
+        break;
+
     default:
+        num();
         break;
     }
 }
 
-NMS_API void formatImpl(String& buf, const NodeEx& tree, StrView/*fmt*/) {
-    const auto capicity = tree.count() * 8 + tree.strlen();
-    buf.reserve(buf.count()+capicity);
-    formatNode(buf, tree, 0);
+NMS_API void parseVal(Scanner& text, bool& val) {
+    const auto s = text.word();
+    if (s == StrView("true")) {
+        val = true;
+    }
+    else if (s == StrView("false")) {
+        val = false;
+    }
+    else {
+        NMS_THROW(EParseFailed{});
+    }
+}
+
+NMS_API void parseVal(Scanner& text, StrView& val) {
+    val = text.str();
+}
+
+NMS_API void parseVal(Scanner& text, DateTime& val) {
+    val = DateTime::parse(text.str());
 }
+#pragma endregion
 
 // parse
 static bool expect(StrView expect, StrView text) {
@@ -158,7 +335,7 @@ static i32 parseStr(StrView& text, NodeEx* ptree, i32 proot, i32 pleft) {
 
     const auto b = 0;
     const auto e = u32(pos-ptr);
-    const auto ret = ptree->add(proot, pleft, Node(StrView{ text.data() + b + 1, e - b - 1 }, Type::string));
+    const auto ret = ptree->add(proot, pleft, Node::escaped(StrView{ text.data() + b + 1, e - b - 1 }, Type::string));
     text = text.slice(e+1, u32(text.count()) - 1);
     return ret;
 }
@@ -171,7 +348,7 @@ static i32 parseKey(StrView& text, NodeEx* ptree, i32 proot, i32 pleft) {
     u32 b = 0;
     u32 e = 1;
     while (text[e] != '"' && text[e - 1] != '\\') ++e;
-    auto ret = ptree->add(proot, pleft, Node(StrView{ text.data() + b + 1,  e - b - 1 }, Type::key));
+    auto ret = ptree->add(proot, pleft, Node::escaped(StrView{ text.data() + b + 1,  e - b - 1 }, Type::key));
     text = text.slice( e + 1, u32(text.count()) - 1);
     return ret;
 }
@@ -351,6 +528,63 @@ nms_test(serialization) {
     io::console::writeln("json = {}", jstr);
 }
 
+nms_test(direct) {
+    TestObject obj;
+    obj.a = "hello";
+    obj.b = { 1, 2, 3 };
+    obj.c = DateTime(2017, 9, 3, 8, 30, 12);
+
+    // struct -> text, same as struct -> tree -> text
+    auto jstr = json::format(obj);
+    {
+        Tree tree;
+        tree << obj;
+        String tstr;
+        formatImpl(tstr, tree, StrView{});
+        test::assert_eq(StrView(jstr), StrView(tstr));
+    }
+
+    // text -> struct
+    TestObject val;
+    json::parse(R"({ "z": [ {"x": null}, 1.5e3 ], "b": [4, 5, 6], "a": "world", "c": "2017-9-3T8:30:12" })", val);
+    test::assert_eq(StrView(val.a), StrView("world"));
+    test::assert_eq(val.b, i32x3{ 4, 5, 6 });
+    test::assert_eq(val.c.stamp(), obj.c.stamp());
+
+    // round trip
+    TestObject out;
+    json::parse(jstr, out);
+    test::assert_eq(StrView(out.a), StrView(obj.a));
+    test::assert_eq(out.b, obj.b);
+}
+
+nms_test(compact) {
+    const char text[] = R"({ "a": "x\"y", "b": [1, 2.5, true, null], "c": {} })";
+    auto tree = json::parse(text);
+
+    // parsed strings are already escaped, written as is
+    String out;
+    formatImpl(out, tree, StrView("json0"));
+    test::assert_eq(StrView(out), StrView(R"({"a":"x\"y","b":[1,2.5,true,null],"c":{}})"));
+
+    // user strings are escaped, and decoded when read back
+    Tree user;
+    user["s"] << StrView("line1\n\"q\"\\");
+    out = StrView{};
+    formatImpl(out, user, StrView("json0"));
+    test::assert_eq(StrView(out), StrView(R"({"s":"line1\n\"q\"\\"})"));
+
+    auto back = json::parse(out);
+    String s;
+    back["s"] >> s;
+    test::assert_eq(StrView(s), StrView("line1\n\"q\"\\"));
+
+    // indent width
+    out = StrView{};
+    formatImpl(out, json::parse("[1, [2]]"), StrView("json2"));
+    test::assert_eq(StrView(out), StrView("[\n  1,\n  [\n    2\n  ]\n]"));
+}
+
 nms_test(deserialization) {
     const char text[] = R"(
 {
@@ -2,6 +2,7 @@
 
 #include <nms/serialization/base.h>
 #include <nms/serialization/node.h>
+#include <nms/serialization/writer.h>
 
 namespace nms::serialization::json
 {
@@ -9,15 +10,251 @@ namespace nms::serialization::json
 NMS_API Tree parse(StrView s);
 NMS_API void formatImpl(String& buf, const NodeEx& tree, StrView fmt);
 
+#pragma region direct: value -> text
+/*
+ * the direct formatter writes values straight into the buffer,
+ * structs are walked with their property metadata, no Tree is built.
+ */
+NMS_API void formatIndent(String& buf, i32 level);
+NMS_API void formatVal(String& buf, StrView         val, i32 level);
+NMS_API void formatVal(String& buf, const DateTime& val, i32 level);
+
+template<class T>
+auto formatVal(String& buf, const T& val, i32 level) -> $when<$is<$number, T> || $is<bool, T>>;
+
+template<class T>
+auto formatVal(String& buf, const T& val, i32 level) -> $when<$is_enum<T>>;
+
+template<u32 N>
+void formatVal(String& buf, const TString<char, N>& val, i32 level);
+
+template<class T, u32 N>
+void formatVal(String& buf, const Vec<T, N>& val, i32 level);
+
+template<class T, u32 S>
+void formatVal(String& buf, const List<T, S>& val, i32 level);
+
+template<class T>
+auto formatVal(String& buf, const T& val, i32 level) -> $when<$is_base_of<ISerializable, T>>;
+
+template<class T>
+auto formatVal(String& buf, const T& val, i32 level) -> $when<$is<$number, T> || $is<bool, T>> {
+    (void)level;
+    nms::formatImpl(buf, StrView{}, val);
+}
+
+template<class T>
+auto formatVal(String& buf, const T& val, i32 level) -> $when<$is_enum<T>> {
+    formatVal(buf, mkEnum(val).name(), level);
+}
+
+template<u32 N>
+void formatVal(String& buf, const TString<char, N>& val, i32 level) {
+    formatVal(buf, StrView(val), level);
+}
+
+template<class T>
+void _formatArray(String& buf, const T* val, u32 cnt, i32 level) {
+    buf += "[\n";
+    for (u32 i = 0; i < cnt; ++i) {
+        formatIndent(buf, level + 1);
+        formatVal(buf, val[i], level + 1);
+        buf += (i + 1 == cnt) ? StrView{ "\n" } : StrView{ ",\n" };
+    }
+    formatIndent(buf, level);
+    buf += "]";
+}
+
+template<class T, u32 N>
+void formatVal(String& buf, const Vec<T, N>& val, i32 level) {
+    _formatArray(buf, val.data_, N, level);
+}
+
+template<class T, u32 S>
+void formatVal(String& buf, const List<T, S>& val, i32 level) {
+    _formatArray(buf, val.data(), val.count(), level);
+}
+
+template<class T>
+auto formatVal(String& buf, const T& val, i32 level) -> $when<$is_base_of<ISerializable, T>> {
+    auto cnt = 0u;
+
+    buf += "{\n";
+    ISerializable::_foreach(val, [&](StrView name, const auto& value) {
+        if (cnt++ != 0) {
+            buf += ",\n";
+        }
+        formatIndent(buf, level + 1);
+        buf += "\"";
+        buf += name;
+        buf += "\": ";
+        formatVal(buf, value, level + 1);
+    });
+    if (cnt != 0) {
+        buf += "\n";
+    }
+    formatIndent(buf, level);
+    buf += "}";
+}
+#pragma endregion
+
+#pragma region direct: text -> value
+/* json scanner, used by the direct parser */
+class Scanner
+{
+public:
+    explicit Scanner(StrView text)
+        : ptr_(text.data()), end_(text.data() + text.count())
+    {}
+
+    /* skip blanks, get next char ('\0' if end) */
+    NMS_API char    peek();
+
+    /* skip blanks, the next char must be c */
+    NMS_API void    expect(char c);
+
+    /* skip blanks, take next char if it is c */
+    NMS_API bool    accept(char c);
+
+    /* "...": string token, without quotes */
+    NMS_API StrView str();
+
+    /* number token */
+    NMS_API StrView num();
+
+    /* true, false, null */
+    NMS_API StrView word();
+
+    /* skip any value */
+    NMS_API void    skip();
+
+protected:
+    const char* ptr_;
+    const char* end_;
+};
+
+NMS_API void parseVal(Scanner& text, bool&     val);
+NMS_API void parseVal(Scanner& text, StrView&  val);
+NMS_API void parseVal(Scanner& text, DateTime& val);
+
+template<class T>
+auto parseVal(Scanner& text, T& val) -> $when<$is<$number, T>>;
+
+template<class T>
+auto parseVal(Scanner& text, T& val) -> $when<$is_enum<T>>;
+
+template<u32 N>
+void parseVal(Scanner& text, TString<char, N>& val);
+
+template<class T, u32 N>
+void parseVal(Scanner& text, Vec<T, N>& val);
+
+template<class T, u32 S>
+void parseVal(Scanner& text, List<T, S>& val);
+
+template<class T>
+auto parseVal(Scanner& text, T& val) -> $when<$is_base_of<ISerializable, T>>;
+
+template<class T>
+auto parseVal(Scanner& text, T& val) -> $when<$is<$number, T>> {
+    val = nms::parse<T>(text.num());
+}
+
+template<class T>
+auto parseVal(Scanner& text, T& val) -> $when<$is_enum<T>> {
+    if (text.peek() == '"') {
+        val = Enum<T>::parse(text.str());
+    }
+    else {
+        val = T(nms::parse<i32>(text.num()));
+    }
+}
+
+template<u32 N>
+void parseVal(Scanner& text, TString<char, N>& val) {
+    val = StrView{};
+    unescapeJson(val, text.str());
+}
+
+template<class T, u32 N>
+void parseVal(Scanner& text, Vec<T, N>& val) {
+    text.expect('[');
+    auto cnt = 0u;
+    if (!text.accept(']')) {
+        do {
+            if (cnt >= N) {
+                NMS_THROW(EUnexpectElementCount{ N, cnt + 1 });
+            }
+            parseVal(text, val[cnt++]);
+        } while (text.accept(','));
+        text.expect(']');
+    }
+    if (cnt != N) {
+        NMS_THROW(EUnexpectElementCount{ N, cnt });
+    }
+}
+
+template<class T, u32 S>
+void parseVal(Scanner& text, List<T, S>& val) {
+    text.expect('[');
+    if (text.accept(']')) {
+        return;
+    }
+    do {
+        T item{};
+        parseVal(text, item);
+        val.append(move(item));
+    } while (text.accept(','));
+    text.expect(']');
+}
+
+template<class T>
+auto parseVal(Scanner& text, T& val) -> $when<$is_base_of<ISerializable, T>> {
+    text.expect('{');
+    if (text.accept('}')) {
+        return;
+    }
+
+    do {
+        const auto key = text.str();
+        text.expect(':');
+
+        // null: keep the default value
+        if (text.peek() == 'n') {
+            text.word();
+            continue;
+        }
+
+        auto found = false;
+        ISerializable::_foreach(val, [&](StrView name, auto& value) {
+            if (!found && name == key) {
+                found = true;
+                parseVal(text, value);
+            }
+        });
+
+        // unknown key
+        if (!found) {
+            text.skip();
+        }
+    } while (text.accept(','));
+    text.expect('}');
+}
+#pragma endregion
+
+/* struct -> json text */
 template<class T, class=$when<$is_base_of<ISerializable, T> > >
 String format(const T& t)  {
-    Tree tree;
-    tree << t;
-
     String str;
-    formatImpl(str, tree, StrView{});
-
+    formatVal(str, t, 0);
     return str;
 }
 
+/* json text -> struct */
+template<class T, class=$when<$is_base_of<ISerializable, T> > >
+void parse(StrView s, T& t) {
+    Scanner text(s);
+    parseVal(text, t);
+}
+
 }
@@ -3,6 +3,9 @@
 #include <nms/serialization/json.h>
 #include <nms/serialization/xml.h>
 #include <nms/io/log.h>
+#include <nms/io/file.h>
+#include <nms/io/console.h>
+#include <nms/test.h>
 
 namespace nms::serialization
 {
@@ -151,11 +154,24 @@ NMS_API i32 NodeEx::add(i32 root, i32 prev, StrView key, const Node& val) {
     return xpos;
 }
 
+/* fmt: json, xml, with optional indent width, eg: json2, json0(compact) */
 NMS_API void NodeEx::format(String& buf, StrView fmt) const {
-    if (fmt == StrView("json")) {
+    auto is_fmt = [=](StrView name) {
+        if (fmt.count() < name.count() || !(StrView{ fmt.data(), name.count() } == name)) {
+            return false;
+        }
+        for (auto i = name.count(); i < fmt.count(); ++i) {
+            if (fmt[i] < '0' || fmt[i] > '9') {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (is_fmt("json")) {
         json::formatImpl(buf, *this, fmt);
     }
-    else if (fmt == StrView("xml")) {
+    else if (is_fmt("xml")) {
         xml::formatImpl(buf, *this, fmt);
     }
     else {
@@ -163,5 +179,204 @@ NMS_API void NodeEx::format(String& buf, StrView fmt) const {
     }
 }
 
+#pragma region snapshot
+/* snapshot file head */
+struct SnapshotHead
+{
+    u8x4    info;       // '$tre'
+    u32     count;      // nodes count
+    i32     root;       // root node index
+    u32     size;       // string pool size
+};
+
+static const u8x4 $snapshot_info = { u8('$'), u8('t'), u8('r'), u8('e') };
+
+static bool has_str(const Node& node) {
+    const auto type = node.type();
+    return (type == Type::string || type == Type::key || type == Type::number) && node.count() != 0;
+}
+
+NMS_API Tree::~Tree() {
+    if (mmap_ptr_ != nullptr) {
+        munmap(mmap_ptr_, mmap_len_);
+        mmap_ptr_ = nullptr;
+        mmap_len_ = 0;
+    }
+}
+
+NMS_API void Tree::save(io::File& file) const {
+    const auto cnt = u32(nodes_.count());
+
+    auto pool_size = 0u;
+    for (u32 i = 0; i < cnt; ++i) {
+        if (has_str(nodes_[i])) {
+            pool_size += nodes_[i].count();
+        }
+    }
+
+    const SnapshotHead head = { $snapshot_info, cnt, idx_, pool_size };
+    file.write(&head, 1);
+
+    // nodes: string pointers -> offsets relative to node
+    auto pool_pos = 0u;
+    for (u32 i = 0; i < cnt; ++i) {
+        auto node = nodes_[i];
+        if (has_str(node)) {
+            node.flag_   |= Node::$relative;
+            node.str_pos_ = i64(cnt - i) * i64(sizeof(Node)) + pool_pos;
+            pool_pos     += node.count();
+        }
+        file.write(&node, 1);
+    }
+
+    // string pool
+    for (u32 i = 0; i < cnt; ++i) {
+        if (has_str(nodes_[i])) {
+            const auto str = nodes_[i].str();
+            file.write(str.data(), str.count());
+        }
+    }
+}
+
+NMS_API void Tree::save(const io::Path& path) const {
+    io::File file(path, io::File::Write);
+    save(file);
 }
 
+NMS_API Tree Tree::load(const io::Path& path) {
+    io::File file(path, io::File::Read);
+
+    const auto file_size = file.size();
+    SnapshotHead head;
+    if (file_size < sizeof(head) || file.read(&head, 1) != 1 || head.info != $snapshot_info) {
+        NMS_THROW(EBadType{});
+    }
+    if (file_size != sizeof(head) + u64(head.count) * sizeof(Node) + head.size) {
+        NMS_THROW(EBadSize{});
+    }
+
+    Tree tree;
+    if (head.count == 0) {
+        return tree;
+    }
+
+    // copy-on-write: cached values never go back to the file
+    const auto ptr  = mmap(file.id(), file_size, false);
+    const auto dat  = reinterpret_cast<Node*>(static_cast<u8*>(ptr) + sizeof(head));
+
+    tree.mmap_ptr_  = ptr;
+    tree.mmap_len_  = file_size;
+
+    // the tree owns the mapping now: a corrupt snapshot throws and unmaps
+    const auto count = i64(head.count);
+    if (head.root < 0 || head.root >= count) {
+        NMS_THROW(EOutOfRange{});
+    }
+
+    // strings must lie in the pool: [pool_beg, file_size)
+    const auto pool_beg = i64(sizeof(head)) + count * i64(sizeof(Node));
+    for (i64 i = 0; i < count; ++i) {
+        const auto& node = dat[i];
+
+        if (node.next_ < 0 || i + node.next_ >= count) {
+            NMS_THROW(EOutOfRange{});
+        }
+
+        const auto type = node.type_;
+        if ((type == Type::array || type == Type::object) && node.size_ != 0) {
+            const auto first = i + (type == Type::array ? 1 : 2);
+            if (first >= count) {
+                NMS_THROW(EOutOfRange{});
+            }
+        }
+
+        if (has_str(node)) {
+            if ((node.flag_ & Node::$relative) == 0) {
+                NMS_THROW(EBadType{});
+            }
+            const auto pos = i64(sizeof(head)) + i * i64(sizeof(Node)) + node.str_pos_;
+            if (pos < pool_beg || pos + node.size_ > i64(file_size)) {
+                NMS_THROW(EOutOfRange{});
+            }
+        }
+    }
+
+    tree.nodes_     = List<Node>::borrow(dat, head.count);
+    tree.idx_       = head.root;
+    return tree;
+}
+#pragma endregion
+
+#pragma region unittest
+nms_test(snapshot) {
+    const char text[] = R"(
+{
+    "name": "nms",
+    "port": 8080,
+    "list": [ "a", "bc", "def" ],
+    "sub" : { "key": "value" }
+}
+)";
+    auto tree = json::parse(text);
+    tree.save("nms.serialization.snapshot.dat");
+
+    auto snap = Tree::load("nms.serialization.snapshot.dat");
+    test::assert_eq(snap["name"].val().str(),       StrView("nms"));
+    test::assert_eq(snap["list"][2u].val().str(),   StrView("def"));
+    test::assert_eq(snap["sub"]["key"].val().str(), StrView("value"));
+    test::assert_eq(u32(snap["port"]), 8080u);
+
+    io::console::writeln("snapshot = {:json}", snap);
+}
+
+nms_test(snapshot_corrupt) {
+    auto tree = json::parse(R"({ "name": "nms", "list": [ "a", "bc" ] })");
+    tree.save("nms.serialization.snapshot.dat");
+
+    const auto size = u32(io::fsize("nms.serialization.snapshot.dat"));
+    u8 buf[1024];
+    {
+        io::File file("nms.serialization.snapshot.dat", io::File::Read);
+        test::assert_eq(file.read(buf, size), u64(size));
+    }
+
+    // write `n` bytes of buf, patched by `patch`, and load it back
+    auto load = [&](u32 n, auto patch) {
+        u8 dat[sizeof(buf)];
+        mcpy(dat, buf, n);
+        patch(dat);
+        {
+            io::File file("nms.serialization.snapshot.dat", io::File::Write);
+            file.write(dat, n);
+        }
+        try {
+            Tree::load("nms.serialization.snapshot.dat");
+        }
+        catch (const IException&) {
+            return false;
+        }
+        return true;
+    };
+
+    const auto none = [](u8*) {};
+    const auto head = 16u;      // sizeof(SnapshotHead)
+    const auto node = u32(sizeof(Node));
+    test::assert_eq(load(size, none), true);
+
+    // truncated: in the head, in the nodes, in the string pool
+    test::assert_eq(load(8, none), false);
+    test::assert_eq(load(head + node, none), false);
+    test::assert_eq(load(size - 1, none), false);
+
+    // root index
+    test::assert_eq(load(size, [](u8* p) { p[8] = 0xFF; }), false);
+
+    // next_ of node 1, past the end
+    test::assert_eq(load(size, [&](u8* p) { p[head + node + 4] = 0x7F; }), false);
+
+    // string offset of node 2 (a key), out of the pool
+    test::assert_eq(load(size, [&](u8* p) { p[head + 2 * node + 8] += 0x40; }), false);
+}
+#pragma endregion
+
+}
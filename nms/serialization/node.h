@@ -1,18 +1,27 @@
 #pragma once
 
 #include <nms/serialization/base.h>
+#include <nms/serialization/writer.h>
+
+namespace nms::io
+{
+class File;
+class Path;
+}
 
 namespace  nms::serialization
 {
 
+class Query;
+
 namespace json
 {
-void formatNode(String& buf, const NodeEx& node, i32 level);
+struct Formatter;
 }
 
 namespace xml
 {
-void formatNode(String& buf, const NodeEx& node, i32 level);
+struct Formatter;
 }
 
 struct Node
@@ -21,8 +30,8 @@ struct Node
     friend struct NodeIterator;
     friend class  Tree;
 
-    friend void json::formatNode(String& buf, const NodeEx& node, i32 level);
-    friend void  xml::formatNode(String& buf, const NodeEx& node, i32 level);
+    friend struct json::Formatter;
+    friend struct  xml::Formatter;
 
     using Tsize = u16;
     using Tnext = i32;
@@ -54,6 +63,34 @@ public:
         : type_(type), size_(size), str_val_(nullptr)
     {}
 
+    /* a string which is already escaped, eg: a slice of the json text */
+    static Node escaped(StrView val, Type type = Type::string) {
+        Node node(val, type);
+        node.flag_ = $escaped;
+        return node;
+    }
+
+    /* copy: a relative string is resolved to an absolute pointer */
+    Node(const Node& rhs) noexcept
+        : type_(rhs.type_), flag_(rhs.flag_ & ~$relative), size_(rhs.size_), next_(rhs.next_), u64_val_(rhs.u64_val_) {
+        if (rhs.flag_ & $relative) {
+            str_val_ = rhs.str_ptr();
+        }
+    }
+
+    /* copy: a relative string is resolved to an absolute pointer */
+    Node& operator=(const Node& rhs) noexcept {
+        type_       = rhs.type_;
+        flag_       = rhs.flag_ & ~$relative;
+        size_       = rhs.size_;
+        next_       = rhs.next_;
+        u64_val_    = rhs.u64_val_;
+        if (rhs.flag_ & $relative) {
+            str_val_ = rhs.str_ptr();
+        }
+        return *this;
+    }
+
     Type type() const {
         return type_;
     }
@@ -70,6 +107,10 @@ public:
         return next_;
     }
 
+    bool isEscaped() const {
+        return (flag_ & $escaped) != 0;
+    }
+
     StrView str() const {
         if (type_ == Type::null) {
             return {};
@@ -78,13 +119,20 @@ public:
         if ((type_ != Type::string) && (type_ != Type::key) && (type_ != Type::number) ) {
             NMS_THROW(EUnexpectType(Type::string, type_));
         }
-        return { str_val_, size_ };
+        return { str_ptr(), size_ };
     }
 
 protected:
     using str_t = const char*;
 
-    Type    type_ = Type::null;  // 2 byte
+    /* flag: str_val_ is an offset relative to this node (see Tree::save) */
+    static constexpr u8 $relative = 0x1;
+
+    /* flag: the string is already escaped, the formatter writes it as is */
+    static constexpr u8 $escaped  = 0x2;
+
+    Type    type_ = Type::null;  // 1 byte
+    u8      flag_ = 0;           // 1 byte
     Tsize   size_ = 0;           // 2 byte
     Tnext   next_ = 0;           // 4 byte
 
@@ -108,14 +156,35 @@ protected:
         str_t   num_val_;
         str_t   str_val_;
         str_t   key_val_;
+        i64     str_pos_;
 
         Node*   arr_val_;
         Node*   obj_val_ = nullptr;
     };
+
+    str_t str_ptr() const {
+        if (flag_ & $relative) {
+            return reinterpret_cast<str_t>(this) + str_pos_;
+        }
+        return str_val_;
+    }
 };
 
+}
+
+namespace nms
+{
+/* nodes in an owned list are never relative, copy is a raw memory copy */
+template<>
+constexpr bool $is_relocatable<serialization::Node> = true;
+}
+
+namespace nms::serialization
+{
+
 struct NodeEx
 {
+    friend class Query;
 
 #pragma region constructort
 public:
@@ -163,7 +232,7 @@ public:
             if (x.type_ != Type::key) {
                 NMS_THROW(EUnexpectType{ Type::key, x.type_ });
             }
-            return { x.key_val_, x.size_ };
+            return x.str();
         }
 
         NodeEx operator*() const {
@@ -224,12 +293,20 @@ public:
 
     /* get key */
     StrView key() const {
-        auto k = lst_[idx_ - 1];
+        auto& k = lst_[idx_ - 1];
         if (k.type_ != Type::key) {
             NMS_THROW(EUnexpectType{ Type::key, k.type_ });
         }
-        StrView val = { k.str_val_, k.size_ };
-        return val;
+        return k.str();
+    }
+
+    /* get key node */
+    const Node& keyNode() const {
+        auto& k = lst_[idx_ - 1];
+        if (k.type_ != Type::key) {
+            NMS_THROW(EUnexpectType{ Type::key, k.type_ });
+        }
+        return k;
     }
 
     /* get val */
@@ -294,7 +371,13 @@ public:
     auto& operator>>(String& x) const {
         StrView y;
         *this >> y;
-        x = y;
+        if (val().isEscaped()) {
+            x = StrView{};
+            unescapeJson(x, y);
+        }
+        else {
+            x = y;
+        }
         return *this;
     }
 #pragma endregion
@@ -547,25 +630,51 @@ public:
         : base(nodes_, 0)
     {}
 
-    ~Tree()
-    {}
+    NMS_API ~Tree();
 
     Tree(Tree&& rhs) noexcept
         : base(nodes_, rhs.idx_)
         , nodes_{ move(rhs.nodes_) }
-    {}
+        , mmap_ptr_{ rhs.mmap_ptr_ }
+        , mmap_len_{ rhs.mmap_len_ }
+    {
+        rhs.mmap_ptr_ = nullptr;
+        rhs.mmap_len_ = 0;
+    }
 
     Tree& operator=(Tree&& rhs) noexcept {
         nms::swap(base::idx_, rhs.idx_);
         nms::swap(nodes_,     rhs.nodes_);
+        nms::swap(mmap_ptr_,  rhs.mmap_ptr_);
+        nms::swap(mmap_len_,  rhs.mmap_len_);
         return *this;
     }
 
     void reserve(u32 cnt) {
         nodes_.reserve(cnt);
     }
+
+#pragma region save/load
+    /*!
+     * save the tree as a snapshot.
+     * strings are stored in a pool after the nodes, and nodes refer to them by relative offsets.
+     */
+    NMS_API void save(io::File& file) const;
+
+    /* save the tree as a snapshot */
+    NMS_API void save(const io::Path& path) const;
+
+    /*!
+     * map a snapshot file into memory.
+     * nodes are used in place without parsing or copying, the mapping lives as long as the tree.
+     */
+    NMS_API static Tree load(const io::Path& path);
+#pragma endregion
+
 protected:
     List<Node>  nodes_;
+    void*       mmap_ptr_ = nullptr;
+    u64         mmap_len_ = 0;
 };
 
 }
@@ -0,0 +1,232 @@
+#include <nms/serialization/query.h>
+#include <nms/serialization/json.h>
+#include <nms/io/console.h>
+#include <nms/test.h>
+
+namespace nms::serialization
+{
+
+NMS_API Query::Query(StrView path)
+    : path_(path) {
+
+    // "" is the root
+    if (path.count() == 0) {
+        return;
+    }
+    if (path[0] != '/') {
+        NMS_THROW(EParseFailed{});
+    }
+
+    text_.reserve(path.count());
+
+    for (u32 i = 1; i <= path.count(); ) {
+        Token token = { Kind::key, u32(text_.count()), 0, 0 };
+
+        // decode: ~0 -> '~', ~1 -> '/'
+        for (; i < path.count() && path[i] != '/'; ++i) {
+            auto c = path[i];
+            if (c == '~' && i + 1 < path.count()) {
+                const auto n = path[++i];
+                c = n == '0' ? '~' : n == '1' ? '/' : n;
+            }
+            text_ += c;
+        }
+        ++i;
+
+        token.len = text_.count() - token.pos;
+        const auto s = key(token);
+
+        if (s == StrView("*")) {
+            token.kind = Kind::any;
+        }
+        else if (s.count() != 0 && s.count() <= 9) {
+            auto num = true;
+            for (auto c : s) {
+                if (c < '0' || c > '9') {
+                    num = false;
+                    break;
+                }
+                token.idx = token.idx * 10 + u32(c - '0');
+            }
+            token.kind = num ? Kind::index : Kind::key;
+        }
+        tokens_.append(token);
+    }
+}
+
+bool Query::match(u32 k, const Node* key, u32 pos) const {
+    const auto& t = tokens_[k];
+
+    switch (t.kind) {
+    case Kind::any:
+        return true;
+
+    case Kind::index:
+        if (key == nullptr) {
+            return t.idx == pos;
+        }
+        return key->str() == this->key(t);
+
+    case Kind::key:
+        return key != nullptr && key->str() == this->key(t);
+    }
+    return false;
+}
+
+/* depth first walk, each node is visited once for all queries */
+class Query::Walker
+{
+public:
+    Walker(const List<Node>& nodes, View<const Query> queries, List<Match>& matches, bool first)
+        : nodes_(nodes), queries_(queries), matches_(matches), first_(first)
+    {}
+
+    void visit(i32 idx, u32 depth, const u32* active, u32 count) {
+        // queries end at this node, the others go on
+        List<u32, 16> next;
+        for (u32 i = 0; i < count; ++i) {
+            const auto q = active[i];
+            if (queries_[q].count() == depth) {
+                matches_.append(Match{ q, idx });
+                if (first_) {
+                    stop_ = true;
+                    return;
+                }
+            }
+            else {
+                next.append(q);
+            }
+        }
+
+        const auto& node = nodes_[idx];
+        const auto  type = node.type();
+        if (next.count() == 0 || node.count() == 0 || (type != Type::array && type != Type::object)) {
+            return;
+        }
+
+        const auto is_obj = type == Type::object;
+
+        auto child = is_obj ? idx + 2 : idx + 1;
+        for (u32 pos = 0; child != 0; ++pos) {
+            const auto key = is_obj ? &nodes_[child - 1] : nullptr;
+
+            List<u32, 16> child_active;
+            for (auto q : next) {
+                if (queries_[q].match(depth, key, pos)) {
+                    child_active.append(q);
+                }
+            }
+            if (child_active.count() != 0) {
+                visit(child, depth + 1, child_active.data(), child_active.count());
+                if (stop_) {
+                    return;
+                }
+            }
+
+            const auto offset = nodes_[child].next();
+            child = offset != 0 ? child + offset : 0;
+        }
+    }
+
+protected:
+    const List<Node>&   nodes_;
+    View<const Query>   queries_;
+    List<Match>&        matches_;
+    bool                first_;
+    bool                stop_ = false;
+};
+
+NMS_API i32 Query::find(const NodeEx& root) const {
+    if (root.lst_.count() == 0) {
+        return 0;
+    }
+
+    List<Match, 1> matches;
+    Walker walker(root.lst_, View<const Query>{ this, 1 }, matches, true);
+
+    const u32 active[] = { 0 };
+    walker.visit(root.idx_, 0, active, 1);
+
+    return matches.count() == 0 ? 0 : matches[0].index;
+}
+
+NMS_API NodeEx Query::get(const NodeEx& root) const {
+    const auto idx = find(root);
+    if (idx == 0) {
+        NMS_THROW(EKeyNotFound{ path_ });
+    }
+    return { root.lst_, idx };
+}
+
+NMS_API void Query::findAll(const NodeEx& root, List<i32>& result) const {
+    if (root.lst_.count() == 0) {
+        return;
+    }
+
+    List<Match> matches;
+    Walker walker(root.lst_, View<const Query>{ this, 1 }, matches, false);
+
+    const u32 active[] = { 0 };
+    walker.visit(root.idx_, 0, active, 1);
+
+    result.reserve(result.count() + matches.count());
+    for (auto& m : matches) {
+        result.append(m.index);
+    }
+}
+
+NMS_API void Query::select(const NodeEx& root, View<const Query> queries, List<Match>& matches) {
+    if (root.lst_.count() == 0 || queries.count() == 0) {
+        return;
+    }
+
+    List<u32, 16> active;
+    for (u32 i = 0; i < queries.count(); ++i) {
+        active.append(i);
+    }
+
+    Walker walker(root.lst_, queries, matches, false);
+    walker.visit(root.idx_, 0, active.data(), active.count());
+}
+
+}
+
+#pragma region unittest
+namespace nms::serialization
+{
+
+nms_test(query) {
+    const char text[] = R"({
+    "a": { "b": [ { "c": 1 }, { "c": 2 }, { "c": 3, "d": 4 } ] },
+    "x/y": "slash",
+    "7": "seven"
+})";
+    auto tree = json::parse(text);
+
+    // single query
+    const Query c2("/a/b/2/c");
+    test::assert_eq(StrView(c2.get(tree).val().str()), StrView("3"));
+    test::assert_eq(c2.count(), 4u);
+
+    test::assert_eq(Query("/a/b/9/c").find(tree), 0);
+    test::assert_eq(Query("").find(tree), 1);
+    test::assert_eq(StrView(Query("/x~1y").get(tree).val().str()), StrView("slash"));
+    test::assert_eq(StrView(Query("/7").get(tree).val().str()), StrView("seven"));
+
+    // wildcard
+    List<i32> all;
+    Query("/a/b/*/c").findAll(tree, all);
+    test::assert_eq(all.count(), 3u);
+
+    // many queries, one pass
+    const Query queries[] = { Query("/a/b/*/d"), Query("/a/b/0/c"), Query("/7") };
+    List<Query::Match> matches;
+    Query::select(tree, queries, matches);
+    test::assert_eq(matches.count(), 3u);
+    test::assert_eq(matches[0].query, 1u);
+    test::assert_eq(matches[1].query, 0u);
+    test::assert_eq(matches[2].query, 2u);
+}
+
+}
+#pragma endregion
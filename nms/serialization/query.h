@@ -0,0 +1,76 @@
+#pragma once
+
+#include <nms/serialization/node.h>
+
+namespace nms::serialization
+{
+
+/*!
+ * compiled path query (json pointer).
+ * "/a/b/3/c": object key `a`, key `b`, array item 3, key `c`.
+ * "*" matches any key or array item, "~0" and "~1" escape '~' and '/'.
+ * the path is parsed once, and can run against any tree.
+ */
+class Query
+{
+public:
+    /* one matched node of a query */
+    struct Match
+    {
+        u32 query;  // index of the query
+        i32 index;  // index of the node
+    };
+
+    NMS_API explicit Query(StrView path);
+
+    /* number of path tokens */
+    u32 count() const {
+        return tokens_.count();
+    }
+
+    /* find the first matched node, returns 0 if not found */
+    NMS_API i32 find(const NodeEx& root) const;
+
+    /* get the first matched node, throws EKeyNotFound if not found */
+    NMS_API NodeEx get(const NodeEx& root) const;
+
+    /* all matched nodes, in document order */
+    NMS_API void findAll(const NodeEx& root, List<i32>& result) const;
+
+    /*!
+     * run many queries in a single pass over the tree.
+     * every node is visited at most once, matches are appended in document order.
+     */
+    NMS_API static void select(const NodeEx& root, View<const Query> queries, List<Match>& matches);
+
+protected:
+    enum class Kind : u8
+    {
+        key,        // object key
+        index,      // array index, or object key
+        any,        // "*"
+    };
+
+    struct Token
+    {
+        Kind    kind;
+        u32     pos;    // key: offset in text_
+        u32     len;    // key: length
+        u32     idx;    // array index
+    };
+
+    String          path_;
+    String          text_;
+    List<Token>     tokens_;
+
+    StrView key(const Token& t) const {
+        return { text_.data() + t.pos, t.len };
+    }
+
+    /* test if token `k` matches a child: `key` for object, `pos` for array */
+    bool match(u32 k, const Node* key, u32 pos) const;
+
+    class Walker;
+};
+
+}
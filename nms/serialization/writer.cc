@@ -0,0 +1,358 @@
+#include <nms/serialization/writer.h>
+#include <nms/io/console.h>
+#include <nms/test.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#ifdef NMS_CC_MSVC
+#include <intrin.h>
+#endif
+#define NMS_SERIALIZATION_SSE2
+#endif
+
+namespace nms::serialization
+{
+
+NMS_API void TextWriter::fill(char c, u32 n) {
+    static const char spaces[] = "                                                                ";
+    static const auto $block = u32(sizeof(spaces) - 1);
+
+    if (c != ' ') {
+        for (u32 i = 0; i < n; ++i) {
+            ptr_[i] = c;
+        }
+        ptr_ += n;
+        return;
+    }
+
+    while (n > $block) {
+        mcpy(ptr_, spaces, $block);
+        ptr_ += $block;
+        n    -= $block;
+    }
+    mcpy(ptr_, spaces, n);
+    ptr_ += n;
+}
+
+NMS_API u32 indentOf(StrView fmt, u32 default_indent) {
+    auto pos = 0u;
+    while (pos < fmt.count() && (fmt[pos] < '0' || fmt[pos] > '9')) {
+        ++pos;
+    }
+    if (pos == fmt.count()) {
+        return default_indent;
+    }
+
+    auto val = 0u;
+    for (; pos < fmt.count() && '0' <= fmt[pos] && fmt[pos] <= '9'; ++pos) {
+        val = val * 10 + u32(fmt[pos] - '0');
+    }
+    return val;
+}
+
+#pragma region number
+NMS_API u32 formatNum(char(&out)[32], u64 val) {
+    // write digits backward, then move to the front
+    char tmp[32];
+    auto pos = 32u;
+    do {
+        tmp[--pos] = char('0' + val % 10);
+        val /= 10;
+    } while (val != 0);
+
+    const auto len = 32u - pos;
+    mcpy(out, tmp + pos, len);
+    return len;
+}
+
+NMS_API u32 formatNum(char(&out)[32], i64 val) {
+    if (val >= 0) {
+        return formatNum(out, u64(val));
+    }
+
+    char tmp[32];
+    const auto len = formatNum(tmp, u64(0) - u64(val));
+    out[0] = '-';
+    mcpy(out + 1, tmp, len);
+    return len + 1;
+}
+
+NMS_API u32 formatNum(char(&out)[32], f64 val, u32 prec) {
+    // same as formatImpl(buf, {}, val)
+    const auto uval = val < 0 ? -val : val;
+    const auto ptr  = val < 0 ? out + 1 : out;
+    const auto cap  = sizeof(out) - u32(ptr - out);
+    auto len = snprintf(ptr, cap, "%.*f", int(prec), uval);
+    if (len < 0 || u32(len) >= cap) {
+        // too long for the fixed notation
+        len = snprintf(ptr, cap, "%g", uval);
+    }
+    if (val < 0) {
+        out[0] = '-';
+        return u32(len + 1);
+    }
+    return u32(len);
+}
+#pragma endregion
+
+#pragma region escape
+#ifdef NMS_SERIALIZATION_SSE2
+static u32 firstBit(u32 mask) {
+#ifdef NMS_CC_MSVC
+    unsigned long idx = 0;
+    _BitScanForward(&idx, mask);
+    return u32(idx);
+#else
+    return u32(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+static bool isJsonEscape(char c) {
+    return c == '"' || c == '\\' || u8(c) < 0x20;
+}
+
+static bool isXmlEscape(char c) {
+    return c == '&' || c == '<' || c == '>';
+}
+
+NMS_API u32 findJsonEscape(const char* s, u32 n) {
+    auto i = 0u;
+
+#ifdef NMS_SERIALIZATION_SSE2
+    // 16 chars a time: '"', '\\', or less than 0x20
+    const auto quote = _mm_set1_epi8('"');
+    const auto slash = _mm_set1_epi8('\\');
+    const auto ctrl  = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const auto m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));
+        const auto mask = u32(_mm_movemask_epi8(m));
+        if (mask != 0) {
+            return i + firstBit(mask);
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (isJsonEscape(s[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+NMS_API u32 findXmlEscape(const char* s, u32 n) {
+    auto i = 0u;
+
+#ifdef NMS_SERIALIZATION_SSE2
+    const auto amp = _mm_set1_epi8('&');
+    const auto lt  = _mm_set1_epi8('<');
+    const auto gt  = _mm_set1_epi8('>');
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const auto m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, lt)),
+            _mm_cmpeq_epi8(v, gt));
+        const auto mask = u32(_mm_movemask_epi8(m));
+        if (mask != 0) {
+            return i + firstBit(mask);
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (isXmlEscape(s[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+NMS_API u32 findChar(const char* s, u32 n, char a, char b) {
+    auto i = 0u;
+
+#ifdef NMS_SERIALIZATION_SSE2
+    const auto va = _mm_set1_epi8(a);
+    const auto vb = _mm_set1_epi8(b);
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const auto m = _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb));
+        const auto mask = u32(_mm_movemask_epi8(m));
+        if (mask != 0) {
+            return i + firstBit(mask);
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (s[i] == a || s[i] == b) {
+            break;
+        }
+    }
+    return i;
+}
+
+NMS_API StrView jsonEscape(char c, char(&tmp)[8]) {
+    switch (c) {
+    case '"':   return "\\\"";
+    case '\\':  return "\\\\";
+    case '\b':  return "\\b";
+    case '\f':  return "\\f";
+    case '\n':  return "\\n";
+    case '\r':  return "\\r";
+    case '\t':  return "\\t";
+    default:    break;
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    tmp[0] = '\\';
+    tmp[1] = 'u';
+    tmp[2] = '0';
+    tmp[3] = '0';
+    tmp[4] = hex[(u8(c) >> 4) & 0xF];
+    tmp[5] = hex[(u8(c) >> 0) & 0xF];
+    return { tmp, 6 };
+}
+
+static u32 parseHex4(const char* s) {
+    auto val = 0u;
+    for (auto i = 0; i < 4; ++i) {
+        const auto c = s[i];
+        val <<= 4;
+        if      ('0' <= c && c <= '9') val |= u32(c - '0');
+        else if ('a' <= c && c <= 'f') val |= u32(c - 'a' + 10);
+        else if ('A' <= c && c <= 'F') val |= u32(c - 'A' + 10);
+        else {
+            NMS_THROW(EParseFailed{});
+        }
+    }
+    return val;
+}
+
+static void appendUtf8(String& buf, u32 code) {
+    if (code < 0x80) {
+        buf += char(code);
+    }
+    else if (code < 0x800) {
+        buf += char(0xC0 | (code >> 6));
+        buf += char(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000) {
+        buf += char(0xE0 | (code >> 12));
+        buf += char(0x80 | ((code >> 6) & 0x3F));
+        buf += char(0x80 | (code & 0x3F));
+    }
+    else {
+        buf += char(0xF0 | (code >> 18));
+        buf += char(0x80 | ((code >> 12) & 0x3F));
+        buf += char(0x80 | ((code >> 6) & 0x3F));
+        buf += char(0x80 | (code & 0x3F));
+    }
+}
+
+NMS_API void unescapeJson(String& buf, StrView s) {
+    const auto n = s.count();
+    buf.reserve(buf.count() + n);
+
+    for (u32 i = 0; i < n; ) {
+        // copy the plain chars as a block
+        auto k = i;
+        while (k < n && s[k] != '\\') {
+            ++k;
+        }
+        buf += StrView{ s.data() + i, k - i };
+        if (k + 1 >= n) {
+            break;
+        }
+
+        const auto c = s[k + 1];
+        i = k + 2;
+        switch (c) {
+        case 'b':   buf += '\b'; break;
+        case 'f':   buf += '\f'; break;
+        case 'n':   buf += '\n'; break;
+        case 'r':   buf += '\r'; break;
+        case 't':   buf += '\t'; break;
+        case 'u': {
+            if (i + 4 > n) {
+                NMS_THROW(EParseFailed{});
+            }
+            auto code = parseHex4(s.data() + i);
+            i += 4;
+
+            // utf-16 surrogate pair
+            if (0xD800 <= code && code < 0xDC00 && i + 6 <= n && s[i] == '\\' && s[i + 1] == 'u') {
+                const auto low = parseHex4(s.data() + i + 2);
+                if (0xDC00 <= low && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+            appendUtf8(buf, code);
+            break;
+        }
+        default:    buf += c; break;
+        }
+    }
+}
+
+NMS_API StrView xmlEscape(char c) {
+    switch (c) {
+    case '&':   return "&amp;";
+    case '<':   return "&lt;";
+    case '>':   return "&gt;";
+    default:    break;
+    }
+    return {};
+}
+#pragma endregion
+
+}
+
+#pragma region unittest
+namespace nms::serialization
+{
+
+nms_test(writer) {
+    // numbers: same as formatImpl
+    char tmp[32];
+    test::assert_eq(StrView(tmp, formatNum(tmp, u64(0))),           StrView("0"));
+    test::assert_eq(StrView(tmp, formatNum(tmp, i64(-1234567890))), StrView("-1234567890"));
+    test::assert_eq(StrView(tmp, formatNum(tmp, 1.5, 3)),           StrView("1.500"));
+    test::assert_eq(StrView(tmp, formatNum(tmp, -0.25, 6)),         StrView("-0.250000"));
+
+    test::assert_eq(indentOf("json",  4), 4u);
+    test::assert_eq(indentOf("json0", 4), 0u);
+    test::assert_eq(indentOf("xml12", 2), 12u);
+
+    // escape: the slow path and the 16 chars block path
+    const StrView text = "0123456789abcdef0123456789\"abc\n";
+    test::assert_eq(findJsonEscape(text.data(), text.count()), 26u);
+    test::assert_eq(findXmlEscape("0123456789abcdef<", 17), 16u);
+    test::assert_eq(findChar(text.data(), text.count(), 'x', '"'), 26u);
+    test::assert_eq(findChar(text.data(), text.count(), 'x', 'y'), text.count());
+
+    String out;
+    formatText(out, [&](auto& sink) { putJsonStr(sink, text); });
+    test::assert_eq(StrView(out), StrView("0123456789abcdef0123456789\\\"abc\\n"));
+
+    // unescape: reverse of putJsonStr
+    String raw;
+    unescapeJson(raw, out);
+    test::assert_eq(StrView(raw), text);
+
+    raw = "";
+    unescapeJson(raw, R"(\u4e2d\ud83d\ude00/)");
+    test::assert_eq(StrView(raw), StrView("\xE4\xB8\xAD\xF0\x9F\x98\x80/"));
+
+    out = "";
+    formatText(out, [&](auto& sink) { putXmlStr(sink, "a<b&c"); sink.fill(' ', 70); });
+    test::assert_eq(out.count(), 12u + 70u);
+    io::console::writeln("xml = '{}'", out);
+}
+
+}
+#pragma endregion
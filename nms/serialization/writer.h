@@ -0,0 +1,171 @@
+#pragma once
+
+#include <nms/serialization/base.h>
+
+namespace nms::serialization
+{
+
+/*!
+ * text output sinks used by the json/xml formatters.
+ * a formatter runs twice: first with TextCounter to get the exact size,
+ * then with TextWriter to fill the buffer, which is allocated only once.
+ */
+
+/* sink: count the output size */
+struct TextCounter
+{
+    u64 size_ = 0;
+
+    void put(char) {
+        ++size_;
+    }
+
+    void put(StrView s) {
+        size_ += s.count();
+    }
+
+    void fill(char, u32 n) {
+        size_ += n;
+    }
+};
+
+/* sink: write to a presized buffer */
+struct TextWriter
+{
+    char* ptr_;
+
+    void put(char c) {
+        *ptr_++ = c;
+    }
+
+    void put(StrView s) {
+        mcpy(ptr_, s.data(), s.count());
+        ptr_ += s.count();
+    }
+
+    /* block write, used for the indentation */
+    NMS_API void fill(char c, u32 n);
+};
+
+/* sink: append to a string */
+struct TextAppender
+{
+    String& buf_;
+
+    void put(char c) {
+        buf_ += c;
+    }
+
+    void put(StrView s) {
+        buf_ += s;
+    }
+
+    void fill(char c, u32 n) {
+        buf_.appends(n, c);
+    }
+};
+
+/* run `func(sink)` twice: count, then write into `buf` */
+template<class F>
+void formatText(String& buf, F&& func) {
+    TextCounter counter;
+    func(counter);
+
+    const auto old_cnt = buf.count();
+    const auto new_cnt = u32(old_cnt + counter.size_);
+    buf.resize(new_cnt);
+
+    TextWriter writer{ buf.data() + old_cnt };
+    func(writer);
+}
+
+/* indent width in the format spec, eg: json2 -> 2, json0 -> 0 (compact) */
+NMS_API u32 indentOf(StrView fmt, u32 default_indent);
+
+#pragma region number
+/* format number to text, returns the length */
+NMS_API u32 formatNum(char(&out)[32], u64 val);
+NMS_API u32 formatNum(char(&out)[32], i64 val);
+NMS_API u32 formatNum(char(&out)[32], f64 val, u32 prec);
+
+template<class Sink, class T>
+auto putNum(Sink& sink, T val) -> $when<$is<$uint, T>> {
+    char tmp[32];
+    sink.put(StrView{ tmp, formatNum(tmp, u64(val)) });
+}
+
+template<class Sink, class T>
+auto putNum(Sink& sink, T val) -> $when<$is<$sint, T>> {
+    char tmp[32];
+    sink.put(StrView{ tmp, formatNum(tmp, i64(val)) });
+}
+
+template<class Sink>
+void putNum(Sink& sink, f32 val) {
+    char tmp[32];
+    sink.put(StrView{ tmp, formatNum(tmp, f64(val), 3) });
+}
+
+template<class Sink>
+void putNum(Sink& sink, f64 val) {
+    char tmp[32];
+    sink.put(StrView{ tmp, formatNum(tmp, val, 6) });
+}
+#pragma endregion
+
+#pragma region escape
+/* find the first char which should be escaped in json string, returns `n` if none */
+NMS_API u32 findJsonEscape(const char* s, u32 n);
+
+/* find the first char which should be escaped in xml text, returns `n` if none */
+NMS_API u32 findXmlEscape(const char* s, u32 n);
+
+/* find the first `a` or `b`, returns `n` if none, used by the parsers */
+NMS_API u32 findChar(const char* s, u32 n, char a, char b);
+
+/* escape sequence of a json char */
+NMS_API StrView jsonEscape(char c, char(&tmp)[8]);
+
+/* escape sequence of a xml char */
+NMS_API StrView xmlEscape(char c);
+
+/* json string -> text, escape sequences are decoded (\uXXXX to utf-8) */
+NMS_API void unescapeJson(String& buf, StrView s);
+
+template<class Sink>
+void putJsonStr(Sink& sink, StrView s) {
+    auto ptr = s.data();
+    auto len = s.count();
+
+    while (len != 0) {
+        const auto pos = findJsonEscape(ptr, len);
+        sink.put(StrView{ ptr, pos });
+        if (pos == len) {
+            break;
+        }
+        char tmp[8];
+        sink.put(jsonEscape(ptr[pos], tmp));
+        ptr += pos + 1;
+        len -= pos + 1;
+    }
+}
+
+template<class Sink>
+void putXmlStr(Sink& sink, StrView s) {
+    auto ptr = s.data();
+    auto len = s.count();
+
+    while (len != 0) {
+        const auto pos = findXmlEscape(ptr, len);
+        sink.put(StrView{ ptr, pos });
+        if (pos == len) {
+            break;
+        }
+        sink.put(xmlEscape(ptr[pos]));
+        ptr += pos + 1;
+        len -= pos + 1;
+    }
+}
+#pragma endregion
+
+}
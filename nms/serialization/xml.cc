@@ -1,4 +1,6 @@
+#include <nms/serialization/xml.h>
 #include <nms/serialization/json.h>
+#include <nms/serialization/writer.h>
 #include <nms/io/log.h>
 #include <nms/io/console.h>
 #include <nms/test.h>
@@ -7,104 +9,436 @@ namespace nms::serialization::xml
 {
 
 // format
-void formatNode(String& buf, const NodeEx& node, i32 level = 0) {
-    static const auto $indent = 2;
-    buf.appends((level + 0)*$indent, ' ');
+struct Formatter
+{
+    u32 indent_;    // indent width, 0: compact
+
+    template<class Sink>
+    void newline(Sink& out) const {
+        if (indent_ != 0) {
+            out.put('\n');
+        }
+    }
 
-    StrView fmt;
+    template<class Sink>
+    void indent(Sink& out, i32 level) const {
+        out.fill(' ', u32(level) * indent_);
+    }
 
-    auto& v = node.val();
+    /* <name type="T">...</name> */
+    template<class Sink, class Name>
+    void element(Sink& out, const Name& name, const NodeEx& val, i32 level) const {
+        const auto type = val.type();
 
-    switch (v.type()) {
-    case Type::null:    formatImpl(buf, fmt, "");           break;
-    case Type::boolean: formatImpl(buf, fmt, v.bool_val_);  break;
-    case Type::u16:     formatImpl(buf, fmt, v.u16_val_);   break;
-    case Type::i16:     formatImpl(buf, fmt, v.i16_val_);   break;
-    case Type::u32:     formatImpl(buf, fmt, v.u32_val_);   break;
-    case Type::i32:     formatImpl(buf, fmt, v.i32_val_);   break;
-    case Type::u64:     formatImpl(buf, fmt, v.u64_val_);   break;
-    case Type::i64:     formatImpl(buf, fmt, v.i64_val_);   break;
-    case Type::f32:     formatImpl(buf, fmt, v.f32_val_);   break;
-    case Type::f64:     formatImpl(buf, fmt, v.f64_val_);   break;
+        indent(out, level);
+        out.put('<');
+        tag(out, name);
+        out.put(" type=\"");
+        out.put(mkEnum(type).name());
+        out.put("\">");
 
-    case Type::datetime:
-        DateTime(v.i64_val_).format(buf, fmt);
-        break;
+        if (type == Type::object || type == Type::array) {
+            newline(out);
+            items(out, val, level + 1);
+            newline(out);
+            indent(out, level);
+        }
+        else {
+            scalar(out, val.val());
+        }
 
-    case Type::number: {
-        formatImpl(buf, fmt, v.str());
-        break;
+        out.put("</");
+        tag(out, name);
+        out.put('>');
     }
 
-    case Type::key: case Type::string: {
-        buf += "\"";
-        formatImpl(buf, fmt, v.str());
-        buf += "\"";
-        break;
+    template<class Sink>
+    void tag(Sink& out, u32 idx) const {
+        putNum(out, idx);
     }
 
-    case Type::array: {
+    template<class Sink>
+    void tag(Sink& out, StrView key) const {
+        out.put(key);
+    }
+
+    /* children of array/object */
+    template<class Sink>
+    void items(Sink& out, const NodeEx& node, i32 level) const {
+        const auto is_obj = node.type() == Type::object;
+
         auto k = 0u;
         for (auto itr = node.begin(); itr != node.end(); ++k, ++itr) {
             if (k != 0) {
-                buf.appends((level + 0) * $indent, ' ');
+                newline(out);
+            }
+            if (is_obj) {
+                element(out, itr.key(), *itr, level);
+            }
+            else {
+                element(out, k, *itr, level);
+            }
+        }
+    }
+
+    template<class Sink>
+    void scalar(Sink& out, const Node& v) const {
+        switch (v.type()) {
+        case Type::boolean: out.put(v.bool_val_ ? StrView("true") : StrView("false")); break;
+        case Type::u8:      putNum(out, v.u8_val_);     break;
+        case Type::i8:      putNum(out, v.i8_val_);     break;
+        case Type::u16:     putNum(out, v.u16_val_);    break;
+        case Type::i16:     putNum(out, v.i16_val_);    break;
+        case Type::u32:     putNum(out, v.u32_val_);    break;
+        case Type::i32:     putNum(out, v.i32_val_);    break;
+        case Type::u64:     putNum(out, v.u64_val_);    break;
+        case Type::i64:     putNum(out, v.i64_val_);    break;
+        case Type::f32:     putNum(out, v.f32_val_);    break;
+        case Type::f64:     putNum(out, v.f64_val_);    break;
+
+        case Type::datetime: {
+            U8String<64> tmp;
+            DateTime(v.i64_val_).format(tmp, {});
+            out.put(tmp);
+            break;
+        }
+
+        case Type::number:
+            out.put(v.str());
+            break;
+
+        case Type::key: case Type::string:
+            out.put('"');
+            putXmlStr(out, v.str());
+            out.put('"');
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    template<class Sink>
+    void document(Sink& out, const NodeEx& tree) const {
+        out.put("<?xml version=\"1.0\" encoding=\"utf-8\" ?>");
+        newline(out);
+        // the root type: an array root is not told from an object by its children
+        out.put("<data type=\"");
+        out.put(mkEnum(tree.type()).name());
+        out.put("\">");
+        newline(out);
+        items(out, tree, 1);
+        newline(out);
+        out.put("</data>");
+        newline(out);
+    }
+};
+
+/* fmt: xml(2 spaces), xml4(4 spaces), xml0(compact) */
+NMS_API void formatImpl(String& buf, const NodeEx& tree, StrView fmt) {
+    const Formatter formatter{ indentOf(fmt, 2) };
+    formatText(buf, [&](auto& sink) { formatter.document(sink, tree); });
+}
+
+
+// parse
+class Parser
+{
+public:
+    Parser(NodeEx& tree, View<char> text)
+        : tree_(tree), ptr_(text.data()), end_(text.data() + text.count())
+    {}
+
+    void document() {
+        misc();
+        element(-1, -1, false);
+        misc();
+        if (ptr_ != end_) {
+            NMS_THROW(EParseFailed{});
+        }
+    }
+
+protected:
+    NodeEx& tree_;
+    char*   ptr_;
+    char*   end_;
+
+    u32 left() const {
+        return u32(end_ - ptr_);
+    }
+
+    static bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool startsWith(StrView s) const {
+        return left() >= s.count() && StrView{ ptr_, s.count() } == s;
+    }
+
+    void blank() {
+        while (ptr_ < end_ && isBlank(*ptr_)) {
+            ++ptr_;
+        }
+    }
+
+    void expect(char c) {
+        if (ptr_ >= end_ || *ptr_ != c) {
+            NMS_THROW(EParseFailed{});
+        }
+        ++ptr_;
+    }
+
+    /* skip to the end of `tail` */
+    void skipTo(StrView tail) {
+        while (true) {
+            ptr_ += findChar(ptr_, left(), tail[0], tail[0]);
+            if (ptr_ == end_) {
+                NMS_THROW(EParseFailed{});
+            }
+            if (startsWith(tail)) {
+                ptr_ += tail.count();
+                return;
             }
+            ++ptr_;
+        }
+    }
 
-            const auto val = *itr;
-            if (val.type() == Type::object || val.type() == Type::array) {
-                sformat(buf, "<{} type=\"{}\">\n", k, val.type());
-                formatNode(buf, val, level + 1);
-                buf += "\n";
-                buf.appends((level + 0) * $indent, ' ');
-                sformat(buf, k + 1 == node.count() ? StrView{ "</{}>" } : StrView{ "</{}>\n" }, k);
+    /* blanks, <?...?>, <!--...-->, <!...> */
+    void misc() {
+        while (true) {
+            blank();
+            if (startsWith("<?")) {
+                skipTo("?>");
+            }
+            else if (startsWith("<!--")) {
+                skipTo("-->");
+            }
+            else if (startsWith("<!") && !startsWith("<![CDATA[")) {
+                skipTo(">");
             }
             else {
-                sformat(buf, "<{} type=\"{}\">", k, val.type());
-                formatNode(buf, val, 0);
-                sformat(buf, k + 1 == node.count() ? StrView{ "</{}>" } : StrView{ "</{}>\n" }, k);
+                return;
             }
         }
-        break;
     }
-    case Type::object: {
-        auto k = 0u;
-        for (auto itr = node.begin(); itr != node.end(); ++k, ++itr) {
-            if (k != 0) {
-                buf.appends((level + 0)*$indent, ' ');
+
+    StrView name() {
+        const auto b = ptr_;
+        while (ptr_ < end_ && !isBlank(*ptr_) && *ptr_ != '>' && *ptr_ != '/' && *ptr_ != '=') {
+            ++ptr_;
+        }
+        if (ptr_ == b) {
+            NMS_THROW(EParseFailed{});
+        }
+        return { b, u32(ptr_ - b) };
+    }
+
+    /* decode entities in place, the text only shrinks */
+    static StrView decode(char* b, char* e) {
+        auto pos = findChar(b, u32(e - b), '&', '&');
+        if (b + pos == e) {
+            return { b, u32(e - b) };
+        }
+
+        auto dst = b + pos;
+        for (auto src = dst; src < e; ) {
+            if (*src != '&') {
+                *dst++ = *src++;
+                continue;
             }
 
-            const auto val = *itr;
-            
+            const auto semi = src + findChar(src, u32(e - src), ';', ';');
+            if (semi == e) {
+                NMS_THROW(EParseFailed{});
+            }
 
-            if (val.type() == Type::object || val.type() == Type::array) {
-                sformat(buf, "<{} type=\"{}\">\n", itr.key(), val.type());
-                formatNode(buf, val, level + 1);
-                buf += "\n";
-                buf.appends((level + 0)*$indent, ' ');
-                sformat(buf, k + 1 == node.count() ? StrView("</{}>") : StrView("</{}>\n"), itr.key());
+            const auto ent = StrView{ src + 1, u32(semi - src - 1) };
+            if      (ent == StrView("lt"))    *dst++ = '<';
+            else if (ent == StrView("gt"))    *dst++ = '>';
+            else if (ent == StrView("amp"))   *dst++ = '&';
+            else if (ent == StrView("quot"))  *dst++ = '"';
+            else if (ent == StrView("apos"))  *dst++ = '\'';
+            else if (ent.count() > 1 && ent[0] == '#') {
+                const auto hex  = ent[1] == 'x';
+                auto       code = 0u;
+                for (auto i = hex ? 2u : 1u; i < ent.count(); ++i) {
+                    const auto c = ent[i];
+                    if      ('0' <= c && c <= '9')          code = code * (hex ? 16 : 10) + u32(c - '0');
+                    else if (hex && 'a' <= c && c <= 'f')   code = code * 16 + u32(c - 'a' + 10);
+                    else if (hex && 'A' <= c && c <= 'F')   code = code * 16 + u32(c - 'A' + 10);
+                    else {
+                        NMS_THROW(EParseFailed{});
+                    }
+                }
+                // utf-8, never longer than the entity itself
+                if (code < 0x80) {
+                    *dst++ = char(code);
+                }
+                else if (code < 0x800) {
+                    *dst++ = char(0xC0 | (code >> 6));
+                    *dst++ = char(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000) {
+                    *dst++ = char(0xE0 | (code >> 12));
+                    *dst++ = char(0x80 | ((code >> 6) & 0x3F));
+                    *dst++ = char(0x80 | (code & 0x3F));
+                }
+                else {
+                    *dst++ = char(0xF0 | (code >> 18));
+                    *dst++ = char(0x80 | ((code >> 12) & 0x3F));
+                    *dst++ = char(0x80 | ((code >> 6) & 0x3F));
+                    *dst++ = char(0x80 | (code & 0x3F));
+                }
             }
             else {
-                sformat(buf, "<{} type=\"{}\">", itr.key(), val.type());
-                formatNode(buf, val, 0);
-                sformat(buf, k + 1 == node.count() ? StrView("</{}>") : StrView("</{}>\n"), itr.key());
+                NMS_THROW(EParseFailed{});
             }
+            src = semi + 1;
         }
-        break;
+        return { b, u32(dst - b) };
     }
-    default:
-        break;
+
+    /* text content, until '<' */
+    StrView text() {
+        if (startsWith("<![CDATA[")) {
+            const auto b = ptr_ + 9;
+            ptr_ = b;
+            skipTo("]]>");
+            return { b, u32(ptr_ - 3 - b) };
+        }
+
+        const auto b = ptr_;
+        ptr_ += findChar(ptr_, left(), '<', '<');
+        return decode(b, ptr_);
     }
-}
 
-NMS_API void formatImpl(String& buf, const NodeEx& tree, StrView/*fmt*/) {
-    const auto capicity = tree.count() * 8 + tree.strlen();
-    buf.reserve(buf.count() + capicity);
+    /* text -> node, by the type attribute */
+    static Node value(Type type, bool typed, StrView s) {
+        switch (type) {
+        case Type::null:
+            return typed ? Node(Type::null) : Node(s);
+
+        case Type::boolean:
+            return Node(s == StrView("true"));
+
+        case Type::i8:  case Type::u8:
+        case Type::i16: case Type::u16:
+        case Type::i32: case Type::u32:
+        case Type::i64: case Type::u64:
+        case Type::f32: case Type::f64:
+        case Type::number:
+            return Node(s, Type::number);
+
+        case Type::string: case Type::key:
+            if (s.count() >= 2 && s[0] == '"' && s[s.count() - 1] == '"') {
+                s = StrView{ s.data() + 1, s.count() - 2 };
+            }
+            return Node(s, Type::string);
+
+        default:
+            return Node(s, Type::string);
+        }
+    }
+
+    /* <name attr="...">...</name> */
+    i32 element(i32 root, i32 prev, bool is_member) {
+        expect('<');
+        const auto tag = name();
+
+        // attributes
+        auto type   = Type::null;
+        auto typed  = false;
+        auto empty  = false;
+        while (true) {
+            blank();
+            if (startsWith("/>")) {
+                ptr_ += 2;
+                empty = true;
+                break;
+            }
+            if (startsWith(">")) {
+                ptr_ += 1;
+                break;
+            }
+
+            const auto attr = name();
+            blank();
+            expect('=');
+            blank();
+            const auto quote = ptr_ < end_ ? *ptr_ : '\0';
+            if (quote != '"' && quote != '\'') {
+                NMS_THROW(EParseFailed{});
+            }
+            const auto b = ++ptr_;
+            ptr_ += findChar(ptr_, left(), quote, quote);
+            if (ptr_ == end_) {
+                NMS_THROW(EParseFailed{});
+            }
+            const auto val = decode(b, ptr_);
+            ++ptr_;
+
+            if (attr == StrView("type")) {
+                type  = Enum<Type>::parse(val);
+                typed = true;
+            }
+        }
+
+        // untyped element with child elements: object
+        if (!typed && !empty) {
+            auto p = ptr_;
+            while (p < end_ && isBlank(*p)) {
+                ++p;
+            }
+            if (p + 1 < end_ && p[0] == '<' && p[1] != '/' && p[1] != '!') {
+                type = Type::object;
+            }
+        }
+
+        const auto is_container = type == Type::array || type == Type::object;
 
-    buf += "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n";
-    buf += "<data>\n";
-    formatNode(buf, tree, 1);
-    buf += "\n";
-    buf += "</data>\n";
+        auto node = Node{ Type::null };
+        if (is_container) {
+            node = Node(type);
+        }
+        else if (!empty) {
+            node = value(type, typed, text());
+        }
+
+        const auto idx = is_member ? tree_.add(root, prev, tag, node) : tree_.add(root, prev, node);
+        if (empty) {
+            return idx;
+        }
+
+        if (is_container) {
+            auto last = -1;
+            while (true) {
+                misc();
+                if (startsWith("</")) {
+                    break;
+                }
+                last = element(idx, last, type == Type::object);
+            }
+        }
+
+        // </name>
+        expect('<');
+        expect('/');
+        if (!(name() == tag)) {
+            NMS_THROW(EParseFailed{});
+        }
+        blank();
+        expect('>');
+        return idx;
+    }
+};
+
+NMS_API Tree parse(View<char> text) {
+    Tree tree;
+    tree.reserve(text.count() / 16);
+
+    Parser parser(tree, text);
+    parser.document();
+    return tree;
 }
 
 }
@@ -144,6 +478,53 @@ nms_test(serialization) {
     tree << obj;
     auto out = format("{:xml}", tree);
     io::console::writeln("out = {}", out);
+
+    auto min = format("{:xml0}", tree);
+    test::assert_eq(StrView(min), StrView(R"(<?xml version="1.0" encoding="utf-8" ?><data type="object"><a type="string">"hello"</a>)"
+        R"(<b type="array"><0 type="u32">1</0><1 type="u32">2</1><2 type="u32">3</2></b></data>)"));
+}
+
+nms_test(parse) {
+    Tree tree;
+    tree["a"] << StrView("x < y & \"z\"");
+    tree["b"] << u32x3{ 1u, 2u, 3u };
+    tree["c"]["d"] << 1.5;
+    tree["c"]["e"] << true;
+
+    // tree -> xml -> tree
+    auto   text = format("{:xml}", tree);
+    auto   back = xml::parse(text);
+
+    test::assert_eq(StrView(format("{:json}", back)), StrView(format("{:json}", tree)));
+
+    String a;
+    back["a"] >> a;
+    test::assert_eq(StrView(a), StrView("x < y & \"z\""));
+
+    u32x3 b;
+    back["b"] >> b;
+    test::assert_eq(b, u32x3{ 1u, 2u, 3u });
+
+    // array root
+    auto arr      = json::parse("[1,2,3]");
+    auto arr_text = format("{:xml}", arr);
+    auto arr_back = xml::parse(arr_text);
+    test::assert_eq(arr_back.type(), Type::array);
+    test::assert_eq(StrView(format("{:json0}", arr_back)), StrView(format("{:json0}", arr)));
+
+    // untyped elements, attributes, comments, cdata
+    String doc = R"(<?xml version="1.0"?>
+<!-- comment -->
+<root>
+    <name lang='en'>caf&#xe9; &amp; bar</name>
+    <code><![CDATA[a<b]]></code>
+    <none/>
+</root>)";
+    auto obj = xml::parse(doc);
+    test::assert_eq(obj.count(), 3u);
+    test::assert_eq(StrView(obj["name"]), StrView("caf\xC3\xA9 & bar"));
+    test::assert_eq(StrView(obj["code"]), StrView("a<b"));
+    test::assert_eq(obj["none"].type(), Type::null);
 }
 
 
@@ -8,6 +8,14 @@ namespace nms::serialization::xml
 
 NMS_API void formatImpl(String& buf, const NodeEx& tree, StrView fmt);
 
+/*!
+ * parse xml text in situ.
+ * nodes refer to the text without copying, entities are decoded in place,
+ * so the text is modified and must live as long as the tree.
+ * the `type` attribute written by formatImpl restores the node types.
+ */
+NMS_API Tree parse(View<char> text);
+
 template<class T, class = $when<$is_base_of<ISerializable, T> > >
 String format(const T& t) {
     Tree tree;
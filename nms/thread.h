@@ -1,5 +1,6 @@
 #pragma once
 
+#include <nms/thread/atomic.h>
 #include <nms/thread/thread.h>
 #include <nms/thread/mutex.h>
 #include <nms/thread/condvar.h>
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <nms/core.h>
+
+#ifdef NMS_CC_MSVC
+#include <intrin.h>
+#endif
+
+namespace nms::thread
+{
+
+/* cache line size, data written by different threads should not share a line */
+constexpr static const u32 $CacheLine = 64;
+
+/*!
+ * atomic 32/64-bit integer or pointer.
+ * load: acquire, store: release, read-modify-write: sequentially consistent.
+ */
+template<class T>
+class Atomic final
+{
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "nms.thread.Atomic: T should be 4 or 8 bytes");
+
+public:
+    constexpr Atomic() noexcept
+        : val_{}
+    {}
+
+    constexpr explicit Atomic(T val) noexcept
+        : val_{ val }
+    {}
+
+    Atomic(const Atomic&)               = delete;
+    Atomic& operator=(const Atomic&)    = delete;
+
+#ifdef NMS_CC_MSVC
+    /* load, acquire */
+    T load() const noexcept {
+        const auto val = val_;
+        _ReadWriteBarrier();
+        return val;
+    }
+
+    /* load, no ordering */
+    T loadRelaxed() const noexcept {
+        return val_;
+    }
+
+    /* store, release */
+    void store(T val) noexcept {
+        _ReadWriteBarrier();
+        val_ = val;
+    }
+
+    /* exchange, returns the old value */
+    T exchange(T val) noexcept {
+        return value(_exchange(ptr(), bits(val)));
+    }
+
+    /* compare and swap, `expected` is updated to the current value on failure */
+    bool cas(T& expected, T desired) noexcept {
+        const auto old = value(_cas(ptr(), bits(desired), bits(expected)));
+        if (old == expected) {
+            return true;
+        }
+        expected = old;
+        return false;
+    }
+
+    /* add, returns the old value (integers only) */
+    T fetchAdd(T delta) noexcept {
+        return value(_add(ptr(), bits(delta)));
+    }
+
+private:
+    using Tbits = Tcond<sizeof(T) == 4, long, __int64>;
+
+    union Tcast
+    {
+        T       val;
+        Tbits   bits;
+    };
+
+    volatile Tbits* ptr() noexcept {
+        return reinterpret_cast<volatile Tbits*>(&val_);
+    }
+
+    static Tbits bits(T val) noexcept {
+        Tcast c;
+        c.val = val;
+        return c.bits;
+    }
+
+    static T value(Tbits bits) noexcept {
+        Tcast c;
+        c.bits = bits;
+        return c.val;
+    }
+
+    static long     _exchange(volatile long*    p, long    v)           { return _InterlockedExchange(p, v);                }
+    static __int64  _exchange(volatile __int64* p, __int64 v)           { return _InterlockedExchange64(p, v);              }
+    static long     _cas(volatile long*    p, long    v, long    e)     { return _InterlockedCompareExchange(p, v, e);      }
+    static __int64  _cas(volatile __int64* p, __int64 v, __int64 e)     { return _InterlockedCompareExchange64(p, v, e);    }
+    static long     _add(volatile long*    p, long    v)                { return _InterlockedExchangeAdd(p, v);             }
+    static __int64  _add(volatile __int64* p, __int64 v)                { return _InterlockedExchangeAdd64(p, v);           }
+#else
+    /* load, acquire */
+    T load() const noexcept {
+        return __atomic_load_n(&val_, __ATOMIC_ACQUIRE);
+    }
+
+    /* load, no ordering */
+    T loadRelaxed() const noexcept {
+        return __atomic_load_n(&val_, __ATOMIC_RELAXED);
+    }
+
+    /* store, release */
+    void store(T val) noexcept {
+        __atomic_store_n(&val_, val, __ATOMIC_RELEASE);
+    }
+
+    /* exchange, returns the old value */
+    T exchange(T val) noexcept {
+        return __atomic_exchange_n(&val_, val, __ATOMIC_SEQ_CST);
+    }
+
+    /* compare and swap, `expected` is updated to the current value on failure */
+    bool cas(T& expected, T desired) noexcept {
+        return __atomic_compare_exchange_n(&val_, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    }
+
+    /* add, returns the old value (integers only) */
+    T fetchAdd(T delta) noexcept {
+        return __atomic_fetch_add(&val_, delta, __ATOMIC_SEQ_CST);
+    }
+#endif
+
+private:
+    volatile T  val_;
+};
+
+}
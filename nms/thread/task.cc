@@ -39,10 +39,8 @@ NMS_API ITask::~ITask()
 {}
 
 bool ITask::addDepend(ITask& task) {
-    for (auto pdepend : depends_) {
-        if (pdepend == &task) {
-            return false;
-        }
+    if (!depends_set_.insert(&task)) {
+        return false;
     }
     depends_ += &task;
     return true;
@@ -51,7 +51,8 @@ public:
 protected:
     State               status_;
     List<ITask*>        depends_;
-    String              name_;
+    HashSet<ITask*>     depends_set_;
+    Symbol              name_;
 
     NMS_API explicit ITask(StrView name);
 
@@ -0,0 +1,82 @@
+#include <nms/test.h>
+#include <nms/util/arraylist.h>
+#include <nms/thread/thread.h>
+#include <nms/io/log.h>
+
+namespace nms
+{
+#pragma region unittest
+
+nms_test(arraylist) {
+    ArrayList<u32, 64, 1000> list;
+
+    // index is in page, not in book
+    for (u32 i = 0; i < 2500; ++i) {
+        list.push(i);
+    }
+    test::assert_eq(list.count(), 2500u);
+    test::assert_eq(list[1234], 1234u);
+    test::assert_eq(list.getPageCount(), 3u);
+    test::assert_eq(list.page(2).count(), 500u);
+
+    // bulk append, across pages
+    u32 values[1500];
+    for (u32 i = 0; i < 1500; ++i) {
+        values[i] = 2500 + i;
+    }
+    test::assert_eq(list.push(values, 1500), 2500u);
+    test::assert_eq(list.count(), 4000u);
+    for (u32 bid = 0; bid < list.getPageCount(); ++bid) {
+        const auto page = list.page(bid);
+        for (u32 i = 0; i < page.count(); ++i) {
+            test::assert_eq(page[i], bid * 1000 + i);
+        }
+    }
+}
+
+nms_test(arraylist_concurrent) {
+    static const u32 $threads = 4;
+    static const u32 $count   = 256 * 1024;
+
+    ArrayList<u32, 1024, 4096> list;
+
+    const auto t0 = clock();
+    {
+        List<thread::Thread, $threads> threads;
+        for (u32 t = 0; t < $threads; ++t) {
+            threads.append([&list, t] {
+                u32 batch[64];
+                for (u32 i = 0; i < $count; i += 64) {
+                    for (u32 k = 0; k < 64; ++k) {
+                        batch[k] = t * $count + i + k;
+                    }
+                    list.push(batch, 64);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    const auto t1 = clock();
+
+    // each value is appended once
+    test::assert_eq(list.count(), $threads * $count);
+
+    List<u8> seen;
+    seen.appends($threads * $count, u8(0));
+    for (u32 bid = 0; bid < list.getPageCount(); ++bid) {
+        for (auto val : list.page(bid)) {
+            seen[val] += 1;
+        }
+    }
+    for (auto s : seen) {
+        test::assert_eq(s, u8(1));
+    }
+
+    io::log::info("nms.ArrayList: {} threads append {} u32: {:.3f} ms", $threads, $threads * $count, (t1 - t0) * 1000);
+}
+
+#pragma endregion
+
+}
@@ -3,111 +3,116 @@
 #include <nms/core/type.h>
 #include <nms/core/view.h>
 #include <nms/core/memory.h>
+#include <nms/thread/atomic.h>
 
 namespace nms
 {
 
+/*!
+ * append-only paged list, many threads may append at the same time.
+ * slots are reserved atomically, pages are allocated on demand and never move,
+ * so references to the items are always valid.
+ * count() and page() are exact when no append is running.
+ */
 template<class T, u32 BookSize, u32 PageSize>
 class ArrayList
     : public INocopyable
 {
 public:
-    using Type = T;
+    using Type  = T;
+    using Tsize = usize;
+
     constexpr static u32 $BookSize  = BookSize;     // count max pages in book
     constexpr static u32 $PageSize  = PageSize;     // count max items in page
 
+    static_assert($is_trivially_copyable<T>, "nms.ArrayList: T should be trivially copyable");
+
     ArrayList()
-        : book_(nullptr), count_(0)
-    {}
+        : book_(mnew<thread::Atomic<T*>>($BookSize))
+    {
+        mzero(book_, $BookSize);
+    }
 
     ~ArrayList() {
-        if (book_ == nullptr) {
-            return;
-        }
-
-        const auto page_count = getPageCount();
-        for (u32 pid = 0; pid < page_count; ++pid) {
-            auto page = book_[pid];
-            mdel(page);
+        for (u32 bid = 0; bid < $BookSize; ++bid) {
+            auto page = book_[bid].load();
+            if (page != nullptr) {
+                mdel(page);
+            }
         }
         mdel(book_);
     }
 
-    const Type& operator[](u32 idx) const {
-        const auto bid  = idx / $BookSize;
-        const auto pid  = idx % $BookSize;
+    const Type& operator[](Tsize idx) const {
+        const auto bid  = idx / $PageSize;
+        const auto pid  = idx % $PageSize;
 
-        const auto& page = book_[bid];
-        const auto& data = page[pid];
-        return data;
+        const auto page = book_[bid].load();
+        return page[pid];
     }
 
-    Type& operator[](u32 idx) {
+    Type& operator[](Tsize idx) {
         const ArrayList& self = *this;
         const auto&      data = self[idx];
         return const_cast<Type&>(data);
     }
 
-    u32 count() const noexcept {
-        return count_;
+    /* count of items, which are appended */
+    Tsize count() const noexcept {
+        return count_.load();
     }
 
     u32 getPageCount() const {
-        const auto value = (count_ + $PageSize - 1) / $PageSize;
-        return value;
+        const auto value = (count() + $PageSize - 1) / $PageSize;
+        return u32(value);
     }
 
-    void push(const Type& value) {
-        const auto idx = count_;
-        const auto bid = idx / $PageSize;
-        const auto pid = idx % $PageSize;
+    /* items in page `bid` */
+    View<const Type> page(u32 bid) const {
+        const auto cnt = count();
+        const auto beg = Tsize(bid) * $PageSize;
+        const auto len = cnt > beg + $PageSize ? Tsize($PageSize) : cnt > beg ? cnt - beg : Tsize(0);
+        return { book_[bid].load(), len };
+    }
 
-        // check if out of range?
-        if (bid >= $BookSize) {
-            NMS_THROW(EOutOfRange{});
-        }
+    /* append an item, returns its index */
+    Tsize push(const Type& value) {
+        const auto idx = reserve(1);
+        getPage(idx / $PageSize)[idx % $PageSize] = value;
+        count_.fetchAdd(1);
+        return idx;
+    }
 
-        // check book
-        if (book_ == nullptr) {
-            book_ = mnew<T*>($BookSize);
-            mzero(book_, $BookSize);
-        }
+    /* append `cnt` items, copied page by page, returns the index of the first one */
+    Tsize push(const Type* values, Tsize cnt) {
+        const auto idx = reserve(cnt);
 
-        // check page
-        if (book_[bid] == nullptr) {
-            book_[bid] = mnew<Type>($PageSize);
+        for (Tsize pos = 0; pos < cnt; ) {
+            const auto bid = (idx + pos) / $PageSize;
+            const auto pid = (idx + pos) % $PageSize;
+            const auto len = min(cnt - pos, Tsize($PageSize - pid));
+            mcpy(getPage(u32(bid)) + pid, values + pos, len);
+            pos += len;
         }
-
-        // add value
-        book_[bid][pid] = value;
-
-        // add count
-        ++count_;
+        count_.fetchAdd(cnt);
+        return idx;
     }
 
     void getData(Type* buff) const {
-        const auto count        = count_;
-        const auto page_count   = getPageCount();
-        const auto last_count   = count - (page_count - 1)*$PageSize;
+        const auto page_count = getPageCount();
 
         for (u32 bid = 0; bid < page_count; ++bid) {
-            const auto src = book_[bid];
-            const auto dst = buff + bid*$PageSize;
-            const auto len = (bid != page_count - 1) ? $PageSize : last_count;
-            mcpy(dst, src, len);
+            const auto src = page(bid);
+            mcpy(buff + Tsize(bid) * $PageSize, src.data(), src.count());
         }
     }
 
-    void setData(Type* buff) {
-        const auto count        = count_;
-        const auto page_count   = (count + $PageSize  - 1) / $PageSize;
-        const auto last_count   = count - (page_count - 1) * $PageSize;
+    void setData(const Type* buff) {
+        const auto page_count = getPageCount();
 
-        for (u32 pid = 0; pid < page_count; ++pid) {
-            const auto dst = book_[pid];
-            const auto src = buff + pid*$PageSize;
-            const auto len = (pid != page_count - 1) ? $PageSize : last_count;
-            mcpy(dst, src, len);
+        for (u32 bid = 0; bid < page_count; ++bid) {
+            const auto dst = page(bid);
+            mcpy(const_cast<Type*>(dst.data()), buff + Tsize(bid) * $PageSize, dst.count());
         }
     }
 
@@ -115,24 +120,49 @@ public:
     template<class OS>
     friend OS& operator<<(OS& os, const ArrayList& list) {
         const auto info       = View<T,1>::info();
-        const auto count      = list.count_;
+        const auto count      = list.count();
         const auto page_count = list.getPageCount();
-        const auto last_count = count - (page_count - 1) * $PageSize;
 
         os.write(&info, 1);
         os.write(&count, 1);
         for (u32 bid = 0; bid < page_count; ++bid) {
-            const auto dat = list.book_[bid];
-            const auto len = (bid != page_count - 1) ? $PageSize : last_count;
-            os.write(dat, len);
+            const auto dat = list.page(bid);
+            os.write(dat.data(), dat.count());
         }
         return os;
     }
 #pragma endregion
 
 protected:
-    T**     book_   = nullptr;
-    u32     count_  = 0;
+    thread::Atomic<T*>*                                 book_;
+    alignas(thread::$CacheLine) thread::Atomic<Tsize>   size_;      // reserved slots
+    alignas(thread::$CacheLine) thread::Atomic<Tsize>   count_;     // appended items
+
+    /* reserve `cnt` slots, returns the first index */
+    Tsize reserve(Tsize cnt) {
+        const auto idx = size_.fetchAdd(cnt);
+        if (idx + cnt > Tsize($BookSize) * $PageSize) {
+            size_.fetchAdd(Tsize(0) - cnt);
+            NMS_THROW(EOutOfRange{});
+        }
+        return idx;
+    }
+
+    /* get the page, allocate it if not exists */
+    T* getPage(u32 bid) {
+        auto page = book_[bid].load();
+        if (page != nullptr) {
+            return page;
+        }
+
+        // the thread which wins the race installs its page
+        auto newpage = mnew<T>($PageSize);
+        if (book_[bid].cas(page, newpage)) {
+            return newpage;
+        }
+        mdel(newpage);
+        return page;
+    }
 };
 
 }
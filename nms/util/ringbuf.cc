@@ -0,0 +1,133 @@
+#include <nms/test.h>
+#include <nms/util/ringbuf.h>
+#include <nms/thread/thread.h>
+#include <nms/io/log.h>
+
+namespace nms
+{
+#pragma region unittest
+
+nms_test(ringbuf) {
+    Ringbuf<u32> buf(4);
+
+    // wrap around: len is still right
+    for (u32 loop = 0; loop < 3; ++loop) {
+        buf.push(1u).push(2u).push(3u);
+        test::assert_eq(buf.len(), 3u);
+        test::assert_eq(buf.pop(), 1u);
+        test::assert_eq(buf.pop(), 2u);
+        test::assert_eq(buf.len(), 1u);
+        test::assert_eq(buf.pop(), 3u);
+    }
+    buf.push(1u).push(2u).push(3u).push(4u);
+    test::assert_eq(buf.isFull(), true);
+
+    SpscRingbuf<u32> spsc(5);
+    test::assert_eq(spsc.capacity(), 8u);
+
+    const u32 vals[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    test::assert_eq(spsc.tryPush(vals, 10), 8u);
+    test::assert_eq(spsc.tryPush(10u), false);
+
+    u32 outs[10];
+    test::assert_eq(spsc.tryPop(outs, 3), 3u);
+    test::assert_eq(outs[2], 2u);
+    test::assert_eq(spsc.len(), 5u);
+}
+
+nms_test(ringbuf_spsc) {
+    static const u32 $count = 1024 * 1024;
+
+    SpscRingbuf<u32> buf(1024);
+
+    const auto t0 = clock();
+    thread::Thread producer([&] {
+        for (u32 i = 0; i < $count; ) {
+            u32 batch[32];
+            for (u32 k = 0; k < 32; ++k) {
+                batch[k] = i + k;
+            }
+            for (u32 k = 0; k < 32; ) {
+                const auto n = u32(buf.tryPush(batch + k, 32 - k));
+                if (n == 0) {
+                    thread::Thread::yield();
+                }
+                k += n;
+            }
+            i += 32;
+        }
+    });
+
+    // items come in order
+    auto errs = 0u;
+    for (u32 i = 0; i < $count; ) {
+        u32 val;
+        if (!buf.tryPop(val)) {
+            thread::Thread::yield();
+            continue;
+        }
+        errs += val == i ? 0 : 1;
+        ++i;
+    }
+    producer.join();
+    const auto t1 = clock();
+
+    test::assert_eq(errs, 0u);
+    io::log::info("nms.SpscRingbuf: transfer {} u32: {:.3f} ms", $count, (t1 - t0) * 1000);
+}
+
+nms_test(ringbuf_mpmc) {
+    static const u32 $threads = 4;
+    static const u32 $count   = 256 * 1024;
+
+    MpmcRingbuf<u64> buf(1024);
+    thread::Atomic<u64> sum;
+    thread::Atomic<u32> done;
+
+    const auto t0 = clock();
+    {
+        List<thread::Thread, $threads * 2> threads;
+        for (u32 t = 0; t < $threads; ++t) {
+            threads.append([&, t] {
+                for (u32 i = 0; i < $count; ) {
+                    if (!buf.tryPush(u64(t) * $count + i)) {
+                        thread::Thread::yield();
+                        continue;
+                    }
+                    ++i;
+                }
+            });
+            threads.append([&] {
+                auto local = u64(0);
+                for (u32 i = 0; i < $count; ) {
+                    u64 vals[16];
+                    const auto n = buf.tryPop(vals, nms::min(16u, $count - i));
+                    if (n == 0) {
+                        thread::Thread::yield();
+                    }
+                    for (u64 k = 0; k < n; ++k) {
+                        local += vals[k];
+                    }
+                    i += u32(n);
+                }
+                sum.fetchAdd(local);
+                done.fetchAdd(1);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    const auto t1 = clock();
+
+    // each value is popped once
+    const auto total = u64($threads) * $count;
+    test::assert_eq(done.load(), $threads);
+    test::assert_eq(sum.load(), total * (total - 1) / 2);
+    test::assert_eq(buf.len(), 0u);
+    io::log::info("nms.MpmcRingbuf: {} producers, {} consumers, transfer {} u64: {:.3f} ms", $threads, $threads, total, (t1 - t0) * 1000);
+}
+
+#pragma endregion
+
+}
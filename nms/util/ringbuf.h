@@ -3,6 +3,7 @@
 #include <nms/core/type.h>
 #include <nms/core/memory.h>
 #include <nms/core/exception.h>
+#include <nms/thread/atomic.h>
 
 namespace  nms
 {
@@ -25,10 +26,14 @@ public:
 
     ~Ringbuf() {
         if (data_ != nullptr) {
+            while (!isEmpty()) {
+                data_[tail_++ % cap_].~T();
+            }
             mdel(data_);
         }
     }
 
+    // top_ and tail_ only increase, the slot is pos % cap_
     // 0123456789
     // ^         ^
     // |         |
@@ -37,8 +42,8 @@ public:
         if (isFull()) {
             NMS_THROW(EOverflow());
         }
-        new(&data_[top_++])T(fwd<U>(val));
-        if (top_ > cap_) top_ = 0;
+        new(&data_[top_ % cap_])T(fwd<U>(val));
+        ++top_;
         return *this;
     }
 
@@ -46,14 +51,15 @@ public:
         if (isEmpty()) {
             NMS_THROW(EEmpty());
         }
-        auto tmp(move(data_[tail_++]));
-        if (tail_ >= cap_) tail_ = 0;
+        auto& val = data_[tail_ % cap_];
+        auto  tmp(move(val));
+        val.~T();
+        ++tail_;
         return tmp;
     }
 
     u64 len() const noexcept {
-        auto result = top_ > tail_ ? top_ - tail_ : cap_ - (cap_ - top_);
-        return result;
+        return top_ - tail_;
     }
 
     bool isFull() const noexcept {
@@ -74,4 +80,236 @@ private:
     u64 tail_   = 0;
 };
 
+/* round up to power of 2 */
+constexpr u64 ringbufCapacity(u64 n) {
+    auto cap = u64(2);
+    while (cap < n) {
+        cap *= 2;
+    }
+    return cap;
+}
+
+/*!
+ * lock-free ring buffer, single producer, single consumer.
+ * capacity is rounded up to power of 2.
+ * each side owns one index, and caches the other one to avoid reading the shared line.
+ */
+template<class T>
+class SpscRingbuf final
+    : public INocopyable
+{
+public:
+    explicit SpscRingbuf(u64 capicity)
+        : mask_(ringbufCapacity(capicity) - 1), data_(mnew<T>(mask_ + 1))
+    {}
+
+    ~SpscRingbuf() {
+        for (auto pos = tail_.loadRelaxed(); pos != top_.loadRelaxed(); ++pos) {
+            data_[pos & mask_].~T();
+        }
+        mdel(data_);
+    }
+
+    u64 capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    /* count of items, exact only if no push/pop is running */
+    u64 len() const noexcept {
+        return top_.load() - tail_.load();
+    }
+
+    /* producer: push an item, returns false if full */
+    template<class U>
+    bool tryPush(U&& val) {
+        const auto top = top_.loadRelaxed();
+        if (top - tail_cache_ > mask_) {
+            tail_cache_ = tail_.load();
+            if (top - tail_cache_ > mask_) {
+                return false;
+            }
+        }
+        new(&data_[top & mask_])T(fwd<U>(val));
+        top_.store(top + 1);
+        return true;
+    }
+
+    /* producer: push at most `cnt` items, returns the count pushed */
+    u64 tryPush(const T* vals, u64 cnt) {
+        const auto top  = top_.loadRelaxed();
+        tail_cache_     = tail_.load();
+
+        const auto space = capacity() - (top - tail_cache_);
+        const auto n     = cnt < space ? cnt : space;
+        for (u64 i = 0; i < n; ++i) {
+            new(&data_[(top + i) & mask_])T(vals[i]);
+        }
+        top_.store(top + n);
+        return n;
+    }
+
+    /* consumer: pop an item, returns false if empty */
+    bool tryPop(T& val) {
+        const auto tail = tail_.loadRelaxed();
+        if (tail == top_cache_) {
+            top_cache_ = top_.load();
+            if (tail == top_cache_) {
+                return false;
+            }
+        }
+        auto& item = data_[tail & mask_];
+        val = move(item);
+        item.~T();
+        tail_.store(tail + 1);
+        return true;
+    }
+
+    /* consumer: pop at most `cnt` items, returns the count popped */
+    u64 tryPop(T* vals, u64 cnt) {
+        const auto tail = tail_.loadRelaxed();
+        top_cache_      = top_.load();
+
+        const auto size = top_cache_ - tail;
+        const auto n    = cnt < size ? cnt : size;
+        for (u64 i = 0; i < n; ++i) {
+            auto& item = data_[(tail + i) & mask_];
+            vals[i] = move(item);
+            item.~T();
+        }
+        tail_.store(tail + n);
+        return n;
+    }
+
+private:
+    const u64   mask_;
+    T*const     data_;
+
+    alignas(thread::$CacheLine) thread::Atomic<u64> top_;           // written by producer
+    u64                                             tail_cache_ = 0;
+    alignas(thread::$CacheLine) thread::Atomic<u64> tail_;          // written by consumer
+    u64                                             top_cache_  = 0;
+};
+
+/*!
+ * lock-free bounded ring buffer, multiple producers, multiple consumers.
+ * capacity is rounded up to power of 2.
+ * each slot has a sequence number: a producer or consumer claims a position with cas,
+ * then publishes the slot by the sequence (slot is free: seq == pos, slot is full: seq == pos + 1).
+ */
+template<class T>
+class MpmcRingbuf final
+    : public INocopyable
+{
+public:
+    explicit MpmcRingbuf(u64 capicity)
+        : mask_(ringbufCapacity(capicity) - 1), data_(mnew<Slot>(mask_ + 1))
+    {
+        for (u64 i = 0; i <= mask_; ++i) {
+            new(&data_[i].seq_)thread::Atomic<u64>(i);
+        }
+    }
+
+    ~MpmcRingbuf() {
+        for (auto pos = tail_.loadRelaxed(); pos != top_.loadRelaxed(); ++pos) {
+            data_[pos & mask_].ptr()->~T();
+        }
+        mdel(data_);
+    }
+
+    u64 capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    /* count of items, exact only if no push/pop is running */
+    u64 len() const noexcept {
+        return top_.load() - tail_.load();
+    }
+
+    /* push an item, returns false if full */
+    template<class U>
+    bool tryPush(U&& val) {
+        auto pos = top_.loadRelaxed();
+        for (;;) {
+            auto&      slot = data_[pos & mask_];
+            const auto seq  = slot.seq_.load();
+            const auto dif  = i64(seq - pos);
+
+            if (dif == 0) {
+                if (top_.cas(pos, pos + 1)) {
+                    new(slot.ptr())T(fwd<U>(val));
+                    slot.seq_.store(pos + 1);
+                    return true;
+                }
+            }
+            else if (dif < 0) {
+                return false;
+            }
+            else {
+                pos = top_.loadRelaxed();
+            }
+        }
+    }
+
+    /* push at most `cnt` items, returns the count pushed */
+    u64 tryPush(const T* vals, u64 cnt) {
+        u64 n = 0;
+        while (n < cnt && tryPush(vals[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+    /* pop an item, returns false if empty */
+    bool tryPop(T& val) {
+        auto pos = tail_.loadRelaxed();
+        for (;;) {
+            auto&      slot = data_[pos & mask_];
+            const auto seq  = slot.seq_.load();
+            const auto dif  = i64(seq - (pos + 1));
+
+            if (dif == 0) {
+                if (tail_.cas(pos, pos + 1)) {
+                    auto item = slot.ptr();
+                    val = move(*item);
+                    item->~T();
+                    slot.seq_.store(pos + mask_ + 1);
+                    return true;
+                }
+            }
+            else if (dif < 0) {
+                return false;
+            }
+            else {
+                pos = tail_.loadRelaxed();
+            }
+        }
+    }
+
+    /* pop at most `cnt` items, returns the count popped */
+    u64 tryPop(T* vals, u64 cnt) {
+        u64 n = 0;
+        while (n < cnt && tryPop(vals[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+private:
+    struct Slot
+    {
+        thread::Atomic<u64> seq_;
+        alignas(T) u8       buf_[sizeof(T)];
+
+        T* ptr() {
+            return reinterpret_cast<T*>(buf_);
+        }
+    };
+
+    const u64   mask_;
+    Slot*const  data_;
+
+    alignas(thread::$CacheLine) thread::Atomic<u64> top_;
+    alignas(thread::$CacheLine) thread::Atomic<u64> tail_;
+};
+
 }